@@ -36,8 +36,38 @@ static const size_t SHA2SIZE[6]={
 #define PKCS_INVALID_LAST       8
 #define PKCS_INVALID_INIT       9
 #define PKCS_INVALID_PD2        10
+#define PKCS_INVALID_KEY        11
+#define PKCS_CRT_FAULT          12
+
+/*
+ * RFC 8017 3.2절의 CRT 개인키 값으로, 각각 길이가 RSAKEYSIZE/16 바이트인 빅엔디언 옥텟 문자열이다.
+ * dP = d mod (p-1), dQ = d mod (q-1), qInv = q^(-1) mod p
+ * 소인수가 세 개(u = 3)이면 세 번째 소수 r에 대한 dR = d mod (r-1), tR = (pq)^(-1) mod r을 더 쓴다.
+ */
+#define RSA_MAX_PRIMES 3
+
+typedef struct {
+    int u;
+    unsigned char p[RSAKEYSIZE/16], q[RSAKEYSIZE/16];
+    unsigned char dP[RSAKEYSIZE/16], dQ[RSAKEYSIZE/16], qInv[RSAKEYSIZE/16];
+    unsigned char r[RSAKEYSIZE/16], dR[RSAKEYSIZE/16], tR[RSAKEYSIZE/16];
+} rsa_crt_t;
+
+/*
+ * 옥텟 문자열에서 한 번 읽어 둔 RSA 키 객체이다. n, e, d와 n의 몽고메리 상수, 있으면 CRT 값을 가진다.
+ */
+typedef struct rsa_key rsa_key_t;
 
 void rsa_generate_key(void *e, void *d, void *n, int mode);
+void rsa_generate_key_crt(void *e, void *d, void *n, rsa_crt_t *crt, int mode);
+void rsa_generate_key_mp(void *e, void *d, void *n, rsa_crt_t *crt, int primes, int mode);
+rsa_key_t *rsa_key_new(const void *e, const void *d, const void *n);
+rsa_key_t *rsa_key_new_crt(const void *e, const void *d, const void *n, const rsa_crt_t *crt);
+void rsa_key_free(rsa_key_t *key);
+int rsaes_oaep_key_encrypt(const void *msg, size_t len, const void *label, const rsa_key_t *key, void *c, int sha2_ndx);
+int rsaes_oaep_key_decrypt(void *msg, size_t *len, const void *label, const rsa_key_t *key, const void *c, int sha2_ndx);
+int rsassa_pss_key_sign(const void *msg, size_t len, const rsa_key_t *key, void *sig, int sha2_ndx);
+int rsassa_pss_key_verify(const void *msg, size_t len, const rsa_key_t *key, const void *sig, int sha2_ndx);
 int rsaes_oaep_encrypt(const void *msg, size_t len, const void *label, const void *e, const void *n, void *c, int sha2_ndx);
 int rsaes_oaep_decrypt(void *msg, size_t *len, const void *label, const void *d, const void *n, const void *c, int sha2_ndx);
 int rsassa_pss_sign(const void *msg, size_t len, const void *d, const void *n, void *sig, int sha2_ndx);
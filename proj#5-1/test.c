@@ -32,6 +32,8 @@ int main(void)
     long x, y;
     int i, val, count;
     size_t len;
+    rsa_key_t *key, *pub;
+    rsa_crt_t crt;
     clock_t start, end;
     double cpu_time;
 
@@ -328,7 +330,106 @@ int main(void)
             fflush(stdout);
         }
     } while (count < 0x5fff);
-    printf("No error found! -- PASSED\n");
+    printf("No error found! -- PASSED\n---\n");
+    
+    /*
+     * <키 객체 시험>
+     * 키를 한 번 읽어 둔 키 객체로 암복호화와 서명, 검증을 하고 기존 인터페이스와 결과가 맞는지 확인한다.
+     * 공개키만 가진 키 객체로는 서명할 수 없어야 한다.
+     */
+    rsa_generate_key(e, d, n, 0);
+    if ((key = rsa_key_new(e, d, n)) == NULL || (pub = rsa_key_new(e, NULL, n)) == NULL) {
+        printf("Key Object Error -- FAILED\n");
+        return 1;
+    }
+    if ((val = rsaes_oaep_key_encrypt("sample data", 12, "label", pub, c, SHA256)) != 0 ||
+        (val = rsaes_oaep_decrypt(m, &len, "label", d, n, c, SHA256)) != 0 || len != 12 || memcmp(m, "sample data", 12) != 0) {
+        printf("Key Object Encryption Error: %d -- FAILED\n", val);
+        return 1;
+    }
+    if ((val = rsaes_oaep_encrypt("sample data", 12, "label", e, n, c, SHA256)) != 0 ||
+        (val = rsaes_oaep_key_decrypt(m, &len, "label", key, c, SHA256)) != 0 || len != 12 || memcmp(m, "sample data", 12) != 0) {
+        printf("Key Object Decryption Error: %d -- FAILED\n", val);
+        return 1;
+    }
+    if ((val = rsassa_pss_key_sign("sample", 6, key, s, SHA256)) != 0 ||
+        (val = rsassa_pss_verify("sample", 6, e, n, s, SHA256)) != 0 ||
+        (val = rsassa_pss_key_verify("sample", 6, pub, s, SHA256)) != 0) {
+        printf("Key Object Signature Error: %d -- FAILED\n", val);
+        return 1;
+    }
+    if ((val = rsassa_pss_key_sign("sample", 6, pub, s, SHA256)) != PKCS_INVALID_KEY) {
+        printf("Signing with a public key: %d -- FAILED\n", val);
+        return 1;
+    }
+    printf("Key Object -- PASSED\n");
+    rsa_key_free(key);
+    
+    /*
+     * <CRT 개인키 시험>
+     * CRT 값으로 만든 키 객체의 서명과 복호화 결과가 d로 계산한 결과와 호환되는지 확인한다.
+     * CRT 값이 틀린 키는 결과를 검산할 때 PKCS_CRT_FAULT로 거부되어야 한다.
+     */
+    rsa_generate_key_crt(e, d, n, &crt, 0);
+    if ((key = rsa_key_new_crt(e, NULL, n, &crt)) == NULL) {
+        printf("CRT Key Object Error -- FAILED\n");
+        return 1;
+    }
+    if ((val = rsassa_pss_key_sign("sample", 6, key, s, SHA512)) != 0 ||
+        (val = rsassa_pss_verify("sample", 6, e, n, s, SHA512)) != 0) {
+        printf("CRT Signature Error: %d -- FAILED\n", val);
+        return 1;
+    }
+    if ((val = rsaes_oaep_encrypt("sample data", 12, "", e, n, c, SHA224)) != 0 ||
+        (val = rsaes_oaep_key_decrypt(m, &len, "", key, c, SHA224)) != 0 || len != 12 || memcmp(m, "sample data", 12) != 0) {
+        printf("CRT Decryption Error: %d -- FAILED\n", val);
+        return 1;
+    }
+    rsa_key_free(pub);
+    if ((pub = rsa_key_new_crt(NULL, d, n, &crt)) != NULL) {
+        printf("CRT Key without e -- FAILED\n");
+        return 1;
+    }
+    crt.qInv[RSAKEYSIZE/16-1] ^= 1;
+    if ((pub = rsa_key_new_crt(e, NULL, n, &crt)) == NULL ||
+        rsaes_oaep_key_decrypt(m, &len, "", pub, c, SHA224) != PKCS_CRT_FAULT ||
+        rsassa_pss_key_sign("sample", 6, pub, s, SHA512) != PKCS_CRT_FAULT) {
+        printf("Corrupted CRT Key -- FAILED\n");
+        return 1;
+    }
+    printf("CRT Private Key -- PASSED\n");
+    rsa_key_free(key);
+    rsa_key_free(pub);
+    
+    /*
+     * <소인수가 세 개인 키 시험>
+     * 세 소수로 만든 키의 n도 RSAKEYSIZE 비트여야 하며, 공개키 연산은 기존 인터페이스로 할 수 있어야 한다.
+     */
+    rsa_generate_key_mp(e, d, n, &crt, 3, 0);
+    if (crt.u != 3 || !(n[0] & 0x80) || (key = rsa_key_new_crt(e, NULL, n, &crt)) == NULL) {
+        printf("3-Prime Key Error -- FAILED\n");
+        return 1;
+    }
+    if ((val = rsassa_pss_key_sign("sample", 6, key, s, SHA384)) != 0 ||
+        (val = rsassa_pss_verify("sample", 6, e, n, s, SHA384)) != 0 ||
+        (val = rsassa_pss_sign("sample", 6, d, n, c, SHA384)) != 0 ||
+        (val = rsassa_pss_key_verify("sample", 6, key, c, SHA384)) != 0) {
+        printf("3-Prime Signature Error: %d -- FAILED\n", val);
+        return 1;
+    }
+    if ((val = rsaes_oaep_encrypt("sample data", 12, "", e, n, c, SHA256)) != 0 ||
+        (val = rsaes_oaep_key_decrypt(m, &len, "", key, c, SHA256)) != 0 || len != 12 || memcmp(m, "sample data", 12) != 0) {
+        printf("3-Prime Decryption Error: %d -- FAILED\n", val);
+        return 1;
+    }
+    crt.tR[RSAKEYSIZE/16-1] ^= 1;
+    rsa_key_free(key);
+    if ((key = rsa_key_new_crt(e, NULL, n, &crt)) == NULL || rsassa_pss_key_sign("sample", 6, key, s, SHA384) != PKCS_CRT_FAULT) {
+        printf("Corrupted 3-Prime Key -- FAILED\n");
+        return 1;
+    }
+    printf("3-Prime Private Key -- PASSED\n");
+    rsa_key_free(key);
     
     end = clock();
     cpu_time = ((double)(end - start)) / CLOCKS_PER_SEC;
@@ -13,12 +13,17 @@
 #include <stdlib.h>
 #endif
 #include "ecdsa.h"
+#include "p256.h"
+#include "p256x4.h"
+#include "p384.h"
+#include "p521.h"
+#include "k256.h"
 #include "sha2.h"
 #include <gmp.h>
 #include <string.h>
-
-mpz_t p, n;
-ecdsa_p256_t G;
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
 
 // sha() - 사용할 sha 함수를 선택
 void sha(const unsigned char *data, unsigned int len, unsigned char *digest, int sha2_ndx)
@@ -67,289 +72,3345 @@ int SHA2SIZE(int sha2_ndx)
    return 0;
 }
 
-// ecc상의 덧셈 계산, P!=Q 인 경우의 계산, 계산 결과 R을 반환해준다
-int ecc_add(ecdsa_p256_t *P, ecdsa_p256_t *Q, ecdsa_p256_t *R)
-{
-    mpz_t x1, y1, x2, y2, x3, y3, tmp;
-    mpz_inits(x1, y1, x2, y2, x3, y3, tmp, NULL);
-    mpz_import(x1, ECDSA_P256/8, 1, 1, 1, 0, P->x);
-    mpz_import(y1, ECDSA_P256/8, 1, 1, 1, 0, P->y);
-    mpz_import(x2, ECDSA_P256/8, 1, 1, 1, 0, Q->x);
-    mpz_import(y2, ECDSA_P256/8, 1, 1, 1, 0, Q->y);
-
-   if(mpz_cmp_ui(x1,0)==0&&mpz_cmp_ui(y1,0)==0){
-      // O + Q = Q
-      mpz_set(x3,x2);
-      mpz_set(y3,y2);
-   }else if(mpz_cmp_ui(x2,0)==0&&mpz_cmp_ui(y2,0)==0){
-      // P + O = P
-      mpz_set(x3,x1);
-      mpz_set(y3,y1);
-   }else{
-    // x3 생성
-    mpz_sub(x3, y2, y1);   // x3 = y2 - y1
-    mpz_sub(tmp, x2, x1);  // tmp = x2 - x1
-
-    // P + Q = O일 경우 오류발생
-    if(mpz_cmp_ui(tmp, 0) == 0){
-      mpz_clears(x1, y1, x2, y2, x3, y3, tmp, NULL);
-      return 1;
-    }
-
-    mpz_invert(tmp, tmp, p);  // inverse(x2 - x1) (mod n)
-    mpz_mul(tmp, x3, tmp);    // tmp = (y2 - y1) / (x2 - x1)
-    mpz_mul(x3, tmp, tmp);    // x3 = ((y2 - y1) / (x2 - x1))^2
-    mpz_sub(x3, x3, x1);      // x3 = ((y2 - y1) / (x2 - x1))^2 - x1
-    mpz_sub(x3, x3, x2);      // x3 = ((y2 - y1) / (x2 - x1))^2 - x1 - x2
-    mpz_mod(x3, x3, p);       // x3 mod n
-
-   // y3 생성
-    mpz_sub(y3, x1, x3);      // y3 = x1 - x3
-    mpz_mul(y3, tmp, y3);     // y3 = ((y2 - y1) / (x2 - x1))(x1 - x3)
-    mpz_sub(y3, y3, y1);      // y3 = ((y2 - y1) / (x2 - x1))(x1 - x3) - y1
-    mpz_mod(y3, y3, p);       // y3 mod n
-   }
-  
-    mpz_export(R->x, NULL, 1, ECDSA_P256/8, 1, 0, x3);
-    mpz_export(R->y, NULL, 1, ECDSA_P256/8, 1, 0, y3);
-    mpz_clears(x1, y1, x2, y2, x3, y3, tmp, NULL);
-    return 0;
+/*
+ * sha()를 나누어 부를 수 있도록 한 SHA-2 해시의 진행 상태이다. 구조체를 복사하면
+ * 중간 상태를 저장해 두었다가 이어서 쓸 수 있으므로 HMAC의 키 상태를 미리 만들어 둘 때 쓴다.
+ */
+typedef struct {
+    int sha2_ndx;
+    union {
+        sha256_ctx s256;
+        sha512_ctx s512;
+    } u;
+} sha2_ctx_t;
+
+static void sha2_init(sha2_ctx_t *c, int sha2_ndx)
+{
+    c->sha2_ndx = sha2_ndx;
+    switch (sha2_ndx) {
+        case SHA224:
+            sha224_init(&c->u.s256);
+            break;
+        case SHA256:
+            sha256_init(&c->u.s256);
+            break;
+        case SHA384:
+            sha384_init(&c->u.s512);
+            break;
+        case SHA512:
+            sha512_init(&c->u.s512);
+            break;
+        case SHA512_224:
+            sha512_224_init(&c->u.s512);
+            break;
+        case SHA512_256:
+            sha512_256_init(&c->u.s512);
+            break;
+    }
+}
+
+static void sha2_update(sha2_ctx_t *c, const unsigned char *data, unsigned int len)
+{
+    switch (c->sha2_ndx) {
+        case SHA224:
+            sha224_update(&c->u.s256, data, len);
+            break;
+        case SHA256:
+            sha256_update(&c->u.s256, data, len);
+            break;
+        case SHA384:
+            sha384_update(&c->u.s512, data, len);
+            break;
+        default:
+            sha512_update(&c->u.s512, data, len);
+            break;
+    }
+}
+
+static void sha2_final(sha2_ctx_t *c, unsigned char *digest)
+{
+    switch (c->sha2_ndx) {
+        case SHA224:
+            sha224_final(&c->u.s256, digest);
+            break;
+        case SHA256:
+            sha256_final(&c->u.s256, digest);
+            break;
+        case SHA384:
+            sha384_final(&c->u.s512, digest);
+            break;
+        case SHA512:
+            sha512_final(&c->u.s512, digest);
+            break;
+        case SHA512_224:
+            sha512_224_final(&c->u.s512, digest);
+            break;
+        case SHA512_256:
+            sha512_256_final(&c->u.s512, digest);
+            break;
+    }
+}
+
+/*
+ * HMAC의 키 상태. 키 K에 대해 (K ^ ipad)와 (K ^ opad)를 흡수한 해시 상태를 저장해 두면
+ * HMAC_K(m)마다 키 블록을 다시 해시하지 않아도 된다.
+ */
+typedef struct {
+    sha2_ctx_t in, out;
+} hmac_key_t;
+
+// 길이가 블록 크기 이하인 키 key로 HMAC의 키 상태 H를 만든다
+static void hmac_setkey(hmac_key_t *H, int sha2_ndx, const unsigned char *key, int klen)
+{
+    unsigned char pad[SHA512_BLOCK_SIZE];
+    int i, bsize = (sha2_ndx == SHA224 || sha2_ndx == SHA256) ? SHA256_BLOCK_SIZE : SHA512_BLOCK_SIZE;
+
+    memset(pad, 0x36, bsize);
+    for (i = 0; i < klen; i++)
+        pad[i] ^= key[i];
+    sha2_init(&H->in, sha2_ndx);
+    sha2_update(&H->in, pad, bsize);
+    memset(pad, 0x5c, bsize);
+    for (i = 0; i < klen; i++)
+        pad[i] ^= key[i];
+    sha2_init(&H->out, sha2_ndx);
+    sha2_update(&H->out, pad, bsize);
+}
+
+// 안쪽 해시 상태 c에 메시지를 모두 흡수한 뒤 HMAC 값을 mac에 넣는다
+static void hmac_finish(const hmac_key_t *H, sha2_ctx_t *c, unsigned char *mac)
+{
+    unsigned char digest[SHA512_DIGEST_SIZE];
+    sha2_ctx_t o = H->out;
+
+    sha2_final(c, digest);
+    sha2_update(&o, digest, SHA2SIZE(c->sha2_ndx));
+    sha2_final(&o, mac);
+}
+
+/*
+ * RFC 6979의 HMAC-DRBG 상태. K는 HMAC 키 상태로, V는 바이트 배열로 들고 있다.
+ * 개인키 x로만 정해지는 값은 문맥의 rfc6979_key_t에 저장해 두고 같은 키로 다시 서명할 때 쓴다.
+ */
+typedef struct {
+    hmac_key_t K;
+    unsigned char V[SHA512_DIGEST_SIZE];
+    int hlen, reseed;
+} rfc6979_t;
+
+/*
+ * RFC 6979 3.2 d단계는 K = 0x00...00, V = 0x01...01로 HMAC_K(V || 0x00 || x || h1)을 계산하므로
+ * h1 앞까지는 x와 해시함수로만 정해진다. K0는 K = 0의 키 상태이고, step_d는 K0의 안쪽 해시에
+ * V || 0x00 || x까지 흡수한 상태이다.
+ */
+typedef struct {
+    int valid, sha2_ndx;
+    unsigned char x[ECDSA_P256/8];
+    hmac_key_t K0;
+    sha2_ctx_t step_d;
+} rfc6979_key_t;
+
+/*
+ * ecc_point_t는 스칼라 곱셈 내부에서 사용하는 자코비안 좌표의 점이다.
+ * (X, Y, Z)는 아핀 좌표 (X/Z^2, Y/Z^3)를 나타내고 Z = 0이면 무한원점 O이다.
+ * 좌표는 계산이 끝날 때까지 p256_fe의 림 형태로 유지되며, 바이트 배열인
+ * ecdsa_p256_t와의 변환은 공개 API의 입구와 출구에서만 일어난다.
+ */
+typedef struct {
+    p256_fe X, Y, Z;
+} ecc_point_t;
+
+// 미리 계산해 두는 표에 저장하는 아핀 좌표의 점이다
+typedef struct {
+    p256_fe x, y;
+} ecc_affine_t;
+
+/*
+ * ecc_proj_t는 완전 덧셈 공식에서 사용하는 동차 사영 좌표의 점이다.
+ * (X : Y : Z)는 아핀 좌표 (X/Z, Y/Z)를 나타내고 무한원점 O는 (0 : 1 : 0)이다.
+ * 비밀 스칼라로 고정 기저 곱셈을 할 때만 쓰며 결과는 ecc_point_t로 바꾸어 돌려준다.
+ */
+typedef struct {
+    p256_fe X, Y, Z;
+} ecc_proj_t;
+
+/*
+ * G의 고정 기저 표. 스칼라를 부호 있는 4비트 자리수 d_i ∈ [-8, 8]로 나누면
+ * kG = Σ d_i * 16^i * G이므로, G_table[i][j-1] = j * 16^i * G (j = 1..8)를 미리 저장해 두면
+ * kG를 두배 연산 없이 표 조회와 덧셈 최대 65번으로 계산할 수 있다. 음수 자리수는 y를 뒤집는다.
+ * 표는 ecdsa_p256_init()에서 한 번 만들며 크기는 65 * 8 * 64바이트 = 약 33KB이다.
+ */
+#define ECC_COMB_WINDOWS (ECDSA_P256/4 + 1)
+#define ECC_COMB_POINTS 8
+
+typedef ecc_affine_t ecc_comb_t[ECC_COMB_WINDOWS][ECC_COMB_POINTS];
+
+// 4레인 고정 기저 곱셈에서 쓰는 G_table의 사본으로, 점마다 x, y를 p256x4의 몽고메리 형태로 저장한다
+typedef p256x4_elt ecc_comb_x4_t[ECC_COMB_WINDOWS][ECC_COMB_POINTS][2];
+
+/*
+ * 임의의 점 P에 대한 곱셈은 폭 w의 NAF(wNAF)를 사용한다. 0이 아닌 자리수는 홀수이고
+ * 사이에 적어도 w-1개의 0이 있으므로 덧셈은 약 256/(w+1)번이며, 음수 자리수는 y만 뒤집는다.
+ * 홀수 배수 P, 3P, ..., (2^(w-1)-1)P를 호출마다 만들고, G는 더 넓은 창의 표를 미리 만들어 둔다.
+ */
+#define ECC_WNAF_BITS (ECDSA_P256 + 1)
+#define ECC_WNAF_W 5
+#define ECC_WNAF_G_W 7
+#define ECC_WNAF_POINTS(w) (1 << ((w) - 2))
+
+/*
+ * 검증에 자주 쓰이는 공개키 Q는 G와 같은 모양의 고정 기저 표를 만들어 캐시에 보관한다.
+ * 항목은 Q의 좌표로 찾고(해시 버킷의 연결 리스트), 가장 오래 쓰이지 않은 것부터 내보낸다(LRU).
+ * 한 번만 쓰이는 키 때문에 표를 만드는 비용을 치르지 않도록, 같은 키가 ECC_CACHE_ADMIT번
+ * 검증에 쓰인 뒤에야 표를 만든다. 그 전까지 항목에는 키와 사용 횟수만 있다.
+ * 항목과 표의 크기 합이 budget을 넘지 않도록 유지한다.
+ */
+#define ECC_CACHE_BUCKETS 256
+#define ECC_CACHE_ADMIT 4
+
+typedef struct ecc_cache_entry {
+    ecdsa_p256_t key;
+    unsigned long uses;
+    ecc_comb_t *tbl;
+    struct ecc_cache_entry *prev, *next;   // LRU 목록, prev 쪽이 최근에 쓰인 항목
+    struct ecc_cache_entry *chain;         // 같은 버킷의 다음 항목
+} ecc_cache_entry_t;
+
+typedef struct {
+    ecc_cache_entry_t *bucket[ECC_CACHE_BUCKETS];
+    ecc_cache_entry_t *head, *tail;
+    size_t budget, used;
+    unsigned long hits, misses;
+} ecc_cache_t;
+
+/*
+ * ECDSA 문맥. 예전에 전역 변수였던 G와 G의 사전 계산 표, 공개키 캐시를 모두 담는다.
+ * 개인키와 k는 문맥의 상태 없이 arc4random_buf()로 만든다.
+ * 문맥 밖에는 상수만 있으므로 서로 다른 문맥은 아무 것도 공유하지 않는다.
+ * 한 번의 서명과 검증에 필요한 임시 공간은 스택이나 호출마다 할당한 메모리를 쓴다.
+ */
+struct ecdsa_ctx {
+    ecc_point_t G;
+    ecc_comb_t G_table;
+    ecc_comb_x4_t G_x4;
+    ecc_affine_t G_odd[ECC_WNAF_POINTS(ECC_WNAF_G_W)];
+    ecc_cache_t cache;
+    rfc6979_key_t nonce_key;
+};
+
+static const p256_fe ONE = {1, 0, 0, 0};
+static const p256_fe B = {0x3bce3c3e27d2604bULL, 0x651d06b0cc53b0f6ULL, 0xb3ebbd55769886bcULL, 0x5ac635d8aa3a93e7ULL};
+
+// ecdsa_p256_*() 함수들이 쓰는 기본 문맥으로 ecdsa_p256_init()에서 만든다
+static ecdsa_ctx_t *ecdsa_default;
+
+/*
+ * 단계별 시간 측정. STAT_BEGIN()으로 시각을 기록하고, STAT_LAP(op, ph)는 앞의 기록 이후의 시간을
+ * 단계 ph에 더한 뒤 기록을 새로 한다. ECDSA_STATS가 없으면 모두 빈 문장이 된다.
+ */
+#define STAT_SIGN   0
+#define STAT_VERIFY 1
+
+#ifdef ECDSA_STATS
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t ecdsa_ticks(void)
+{
+    return __rdtsc();
+}
+#else
+static inline uint64_t ecdsa_ticks(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+static _Atomic unsigned long long ecdsa_stat_calls[2];
+static _Atomic unsigned long long ecdsa_stat_ticks[2][ECDSA_STAT_PHASES];
+
+#define STAT_DECL uint64_t stat_t0, stat_t1
+#define STAT_BEGIN(op) \
+    (atomic_fetch_add_explicit(&ecdsa_stat_calls[op], 1, memory_order_relaxed), stat_t0 = ecdsa_ticks())
+#define STAT_LAP(op, ph) \
+    (stat_t1 = ecdsa_ticks(), \
+     atomic_fetch_add_explicit(&ecdsa_stat_ticks[op][ph], stat_t1 - stat_t0, memory_order_relaxed), \
+     stat_t0 = stat_t1)
+#else
+#define STAT_DECL int stat_unused __attribute__((unused))
+#define STAT_BEGIN(op) ((void)0)
+#define STAT_LAP(op, ph) ((void)0)
+#endif
+
+// 아핀 좌표의 ecdsa_p256_t를 내부 표현으로 가져온다. (0, 0)은 무한원점 O로 본다
+static void ecc_point_import(ecc_point_t *P, const ecdsa_p256_t *A)
+{
+    p256_fe_from_bytes(P->X, A->x);
+    p256_fe_from_bytes(P->Y, A->y);
+    if (p256_fe_is_zero(P->X) && p256_fe_is_zero(P->Y))
+        p256_fe_set_ui(P->Z, 0);
+    else
+        p256_fe_set_ui(P->Z, 1);
+}
+
+// 정규화된 점(Z = 1)을 ecdsa_p256_t로 내보낸다. O는 (0, 0)으로 나타낸다
+static void ecc_point_export(ecdsa_p256_t *A, const ecc_point_t *P)
+{
+    if (p256_fe_is_zero(P->Z)) {
+        memset(A->x, 0, ECDSA_P256/8);
+        memset(A->y, 0, ECDSA_P256/8);
+        return;
+    }
+    p256_fe_to_bytes(A->x, P->X);
+    p256_fe_to_bytes(A->y, P->Y);
+}
+
+// t = x^3 - 3x + b, 곡선 y^2 = x^3 - 3x + b의 우변이다
+static void ecc_curve_rhs(p256_fe t, const p256_fe x)
+{
+    p256_fe u;
+
+    p256_fe_sqr(t, x);
+    p256_fe_mul(t, t, x);
+    p256_fe_add(u, x, x);
+    p256_fe_add(u, u, x);
+    p256_fe_sub(t, t, u);
+    p256_fe_add(t, t, B);
+}
+
+// 아핀 좌표의 (x, y)가 곡선 위에 있으면 1을 반환한다
+static int ecc_on_curve(const p256_fe x, const p256_fe y)
+{
+    p256_fe t, u;
+
+    ecc_curve_rhs(t, x);
+    p256_fe_sqr(u, y);
+    return p256_fe_equal(t, u);
+}
+
+// x좌표가 x이고 y가 짝수인 곡선 위의 점의 y를 구한다. 그런 점이 없으면 0을 반환한다
+static int ecc_lift_x(p256_fe y, const p256_fe x)
+{
+    p256_fe t;
+
+    ecc_curve_rhs(t, x);
+    if (!p256_fe_sqrt(y, t))
+        return 0;
+    if (y[0] & 1)
+        p256_fe_neg(y, y);
+    return 1;
+}
+
+// 자코비안 좌표를 아핀 좌표 (X/Z^2, Y/Z^3, 1)로 바꾼다. 역원은 여기서 한 번만 계산한다
+static void ecc_normalize(ecc_point_t *P)
+{
+    p256_fe zinv, t;
+
+    if (p256_fe_is_zero(P->Z) || p256_fe_equal(P->Z, ONE))
+        return;
+    p256_fe_inv(zinv, P->Z);
+    p256_fe_sqr(t, zinv);           // Z^-2
+    p256_fe_mul(P->X, P->X, t);
+    p256_fe_mul(t, t, zinv);        // Z^-3
+    p256_fe_mul(P->Y, P->Y, t);
+    p256_fe_set_ui(P->Z, 1);
+}
+
+/*
+ * ecc_normalize_batch() - 점 cnt개를 한 번의 역원 계산으로 정규화한다.
+ * 몽고메리의 동시 역원 기법으로 Z들의 누적 곱을 만든 뒤 그 역원 하나에서 각 Z^-1을 되돌려 얻는다.
+ * 무한원점은 건너뛴다.
+ */
+static void ecc_normalize_batch(ecc_point_t *P, int cnt)
+{
+    p256_fe *acc, inv, zinv, t;
+    int i;
+
+    if ((acc = malloc(cnt * sizeof(p256_fe))) == NULL) {
+        for (i = 0; i < cnt; i++)
+            ecc_normalize(&P[i]);
+        return;
+    }
+    // acc[i] = Z_0 * Z_1 * ... * Z_i
+    p256_fe_copy(inv, ONE);
+    for (i = 0; i < cnt; i++) {
+        if (!p256_fe_is_zero(P[i].Z))
+            p256_fe_mul(inv, inv, P[i].Z);
+        p256_fe_copy(acc[i], inv);
+    }
+    p256_fe_inv(inv, inv);
+    for (i = cnt - 1; i >= 0; i--) {
+        if (p256_fe_is_zero(P[i].Z))
+            continue;
+        // Z_i^-1 = (Z_0 * ... * Z_i)^-1 * (Z_0 * ... * Z_(i-1))
+        if (i > 0)
+            p256_fe_mul(zinv, inv, acc[i-1]);
+        else
+            p256_fe_copy(zinv, inv);
+        p256_fe_mul(inv, inv, P[i].Z);
+        p256_fe_sqr(t, zinv);
+        p256_fe_mul(P[i].X, P[i].X, t);
+        p256_fe_mul(t, t, zinv);
+        p256_fe_mul(P[i].Y, P[i].Y, t);
+        p256_fe_set_ui(P[i].Z, 1);
+    }
+    free(acc);
+}
+
+// 자코비안 좌표에서 P = 2P를 계산한다. P-256은 a = -3이므로 3(X-Z^2)(X+Z^2)을 사용한다
+static void ecc_doubling(ecc_point_t *P)
+{
+    p256_fe delta, gamma, beta, alpha, t;
+
+    p256_fe_sqr(delta, P->Z);           // delta = Z^2
+    p256_fe_sqr(gamma, P->Y);           // gamma = Y^2
+    p256_fe_mul(beta, P->X, gamma);     // beta = X*gamma
+    p256_fe_sub(alpha, P->X, delta);
+    p256_fe_add(t, P->X, delta);
+    p256_fe_mul(alpha, alpha, t);
+    p256_fe_add(t, alpha, alpha);
+    p256_fe_add(alpha, alpha, t);       // alpha = 3(X - delta)(X + delta)
+
+    // Z3 = (Y + Z)^2 - gamma - delta
+    p256_fe_add(P->Z, P->Y, P->Z);
+    p256_fe_sqr(P->Z, P->Z);
+    p256_fe_sub(P->Z, P->Z, gamma);
+    p256_fe_sub(P->Z, P->Z, delta);
+    // X3 = alpha^2 - 8beta
+    p256_fe_add(beta, beta, beta);
+    p256_fe_add(beta, beta, beta);      // beta = 4beta
+    p256_fe_sqr(P->X, alpha);
+    p256_fe_sub(P->X, P->X, beta);
+    p256_fe_sub(P->X, P->X, beta);
+    // Y3 = alpha(4beta - X3) - 8gamma^2
+    p256_fe_sub(beta, beta, P->X);
+    p256_fe_mul(P->Y, alpha, beta);
+    p256_fe_sqr(gamma, gamma);
+    p256_fe_add(gamma, gamma, gamma);
+    p256_fe_add(gamma, gamma, gamma);
+    p256_fe_add(gamma, gamma, gamma);
+    p256_fe_sub(P->Y, P->Y, gamma);
+}
+
+/*
+ * ecc_add() - 자코비안 좌표에서 P = P + Q를 계산한다.
+ * Q의 Z가 1이면(아핀 좌표) 곱셈 몇 번을 생략한다. P = O, Q = O, P = Q, P = -Q인 경우도 처리한다.
+ */
+static void ecc_add(ecc_point_t *P, const ecc_point_t *Q)
+{
+    p256_fe z1z1, u1, s1, h, r, i, j, t;
+    int affine = p256_fe_equal(Q->Z, ONE);
+
+    // Q = O이면 P는 그대로이고, P = O이면 P + Q = Q
+    if (p256_fe_is_zero(Q->Z))
+        return;
+    if (p256_fe_is_zero(P->Z)) {
+        *P = *Q;
+        return;
+    }
+
+    p256_fe_sqr(z1z1, P->Z);
+    if (affine) {
+        p256_fe_copy(u1, P->X);
+        p256_fe_copy(s1, P->Y);
+    }
+    else {
+        p256_fe_sqr(t, Q->Z);
+        p256_fe_mul(u1, P->X, t);           // U1 = X1*Z2^2
+        p256_fe_mul(t, t, Q->Z);
+        p256_fe_mul(s1, P->Y, t);           // S1 = Y1*Z2^3
+    }
+    p256_fe_mul(h, Q->X, z1z1);
+    p256_fe_sub(h, h, u1);                  // H = X2*Z1^2 - U1
+    p256_fe_mul(r, P->Z, z1z1);
+    p256_fe_mul(r, Q->Y, r);
+    p256_fe_sub(r, r, s1);
+    p256_fe_add(r, r, r);                   // r = 2(Y2*Z1^3 - S1)
+
+    if (p256_fe_is_zero(h)) {
+        if (p256_fe_is_zero(r))
+            ecc_doubling(P);                // P = Q이므로 2P를 계산한다
+        else
+            p256_fe_set_ui(P->Z, 0);        // P = -Q이므로 P + Q = O
+        return;
+    }
+
+    // Z3 = 2*Z1*Z2*H
+    p256_fe_mul(P->Z, P->Z, h);
+    if (!affine)
+        p256_fe_mul(P->Z, P->Z, Q->Z);
+    p256_fe_add(P->Z, P->Z, P->Z);
+    // I = (2H)^2, J = H*I, V = U1*I
+    p256_fe_add(i, h, h);
+    p256_fe_sqr(i, i);
+    p256_fe_mul(j, h, i);
+    p256_fe_mul(u1, u1, i);
+    // X3 = r^2 - J - 2V
+    p256_fe_sqr(P->X, r);
+    p256_fe_sub(P->X, P->X, j);
+    p256_fe_sub(P->X, P->X, u1);
+    p256_fe_sub(P->X, P->X, u1);
+    // Y3 = r(V - X3) - 2*S1*J
+    p256_fe_sub(u1, u1, P->X);
+    p256_fe_mul(P->Y, r, u1);
+    p256_fe_mul(s1, s1, j);
+    p256_fe_add(s1, s1, s1);
+    p256_fe_sub(P->Y, P->Y, s1);
+}
+
+// 자코비안 좌표의 P에 아핀 좌표의 점 Q를 더한다
+static void ecc_add_affine(ecc_point_t *P, const ecc_affine_t *Q)
+{
+    ecc_point_t T;
+
+    p256_fe_copy(T.X, Q->x);
+    p256_fe_copy(T.Y, Q->y);
+    p256_fe_set_ui(T.Z, 1);
+    ecc_add(P, &T);
+}
+
+// tbl[i] = (2i+1)P (i = 0..cnt-1)를 만든다. P는 무한원점이 아니어야 한다
+static void ecc_odd_multiples(ecc_affine_t *tbl, const ecc_point_t *P, int cnt)
+{
+    ecc_point_t T[ECC_WNAF_POINTS(ECC_WNAF_G_W)], P2;
+    int i;
+
+    P2 = *P;
+    ecc_doubling(&P2);
+    T[0] = *P;
+    for (i = 1; i < cnt; i++) {
+        T[i] = T[i-1];
+        ecc_add(&T[i], &P2);
+    }
+    ecc_normalize_batch(T, cnt);
+    for (i = 0; i < cnt; i++) {
+        p256_fe_copy(tbl[i].x, T[i].X);
+        p256_fe_copy(tbl[i].y, T[i].Y);
+    }
 }
 
-// ecc상의 덧셈 계산, P=Q인 경우 즉 2P계산 결과를 R으로 반환해준다
-int ecc_doubling(ecdsa_p256_t *P, ecdsa_p256_t *R)
-{
-    mpz_t x1, y1, x3, y3, tmp;
-    mpz_inits(x1, y1, x3, y3, tmp, NULL);
-    mpz_import(x1, ECDSA_P256/8, 1, 1, 1, 0, P->x);
-    mpz_import(y1, ECDSA_P256/8, 1, 1, 1, 0, P->y);
-
-    // x3 생성
-    mpz_mul(x3, x1, x1);      // x3 = x1^2
-    mpz_mul_ui(x3, x3, 3);    // x3 = 3x1^2
-    mpz_sub_ui(x3, x3, 3);    // x3 = 3x1^2 - 3
-    mpz_mul_ui(tmp, y1, 2);   // tmp = 2y1
-    mpz_invert(tmp, tmp, p);  // inverse(2y1)(mod n)
-    mpz_mul(tmp, x3, tmp);    // tmp = (3x1^2 - 3) / 2y1
-    mpz_mul(x3, tmp, tmp);    // x3 = ((3x1^2 - 3) / 2y1)^2
-    mpz_sub(x3, x3, x1);      // x3 = ((3x1^2 - 3) / 2y1)^2 - x1
-    mpz_sub(x3, x3, x1);      // x3 = ((3x1^2 - 3) / 2y1)^2 - 2x1
-    mpz_mod(x3, x3, p);
-
-    // y3 생성
-    mpz_sub(y3, x1, x3);      // y3 = x1 - x3
-    mpz_mul(y3, tmp, y3);     // y3 = ((3x1^2 - 3) / 2y1)(x1 - x3)
-    mpz_sub(y3, y3, y1);      // y3 = ((3x1^2 - 3) / 2y1)(x1 - x3) - y1
-    mpz_mod(y3, y3, p);
-    
-    mpz_export(R->x, NULL, 1, ECDSA_P256/8, 1, 0, x3);
-    mpz_export(R->y, NULL, 1, ECDSA_P256/8, 1, 0, y3);
-    mpz_clears(x1, y1, x3, y3, tmp, NULL);
+// tbl[i][j-1] = j * 16^i * P를 만든다. 자코비안 좌표로 모두 계산한 뒤 한꺼번에 정규화한다
+// 메모리를 할당하지 못하면 -1을 반환한다
+static int ecc_comb_table(ecc_comb_t tbl, const ecc_point_t *P)
+{
+    ecc_point_t *T, B;
+    int i, j;
+
+    if ((T = malloc(ECC_COMB_WINDOWS * ECC_COMB_POINTS * sizeof(ecc_point_t))) == NULL)
+        return -1;
+    B = *P;
+    for (i = 0; i < ECC_COMB_WINDOWS; i++) {
+        // T[i][j] = (j+1) * 16^i * P
+        T[i*ECC_COMB_POINTS] = B;
+        for (j = 1; j < ECC_COMB_POINTS; j++) {
+            T[i*ECC_COMB_POINTS + j] = T[i*ECC_COMB_POINTS + j - 1];
+            ecc_add(&T[i*ECC_COMB_POINTS + j], &B);
+        }
+        // B = 16 * 16^i * P = 2 * (8 * 16^i * P)
+        B = T[i*ECC_COMB_POINTS + ECC_COMB_POINTS - 1];
+        ecc_doubling(&B);
+    }
+    ecc_normalize_batch(T, ECC_COMB_WINDOWS * ECC_COMB_POINTS);
+    for (i = 0; i < ECC_COMB_WINDOWS; i++)
+        for (j = 0; j < ECC_COMB_POINTS; j++) {
+            p256_fe_copy(tbl[i][j].x, T[i*ECC_COMB_POINTS + j].X);
+            p256_fe_copy(tbl[i][j].y, T[i*ECC_COMB_POINTS + j].Y);
+        }
+    free(T);
     return 0;
 }
 
-// ecc상의 곱셈, square multiply 활용하여 A를 d번더하는 계산을 수행한다
-void ecc_mul(ecdsa_p256_t *X, mpz_t d, ecdsa_p256_t *Y)
+// k를 부호 있는 4비트 자리수로 바꾼다. k = Σ d_i * 16^i, d_i ∈ [-8, 7], 마지막 자리수는 올림수 0 또는 1이다
+static void ecc_recode_signed4(signed char d[ECC_COMB_WINDOWS], const p256_sc k)
 {
-    unsigned long int i = 0;
-    unsigned long int bin_bits = ECDSA_P256;
+    int i, w, carry = 0;
 
-    // i = d 이고 i=d이기 전까지 계속 Y에 X를 더해준다
-    while(i <= bin_bits){
-        if(mpz_tstbit(d, i)==1) ecc_add(Y, X, Y);
-        // X+X 즉 X를 두배로만들고 저장(비트를 shift하는 square multiply 방식과 유사)
-        ecc_doubling(X, X);
-        i++;
-   }
+    for (i = 0; i < ECC_COMB_WINDOWS - 1; i++) {
+        w = (int)((k[i/16] >> (4 * (i%16))) & 0xf) + carry;
+        carry = (w + 8) >> 4;
+        d[i] = (signed char)(w - (carry << 4));
+    }
+    d[ECC_COMB_WINDOWS - 1] = (signed char)carry;
 }
 
 /*
- * Initialize 256 bit ECDSA parameters
- * 시스템파라미터 p, n, G의 공간을 할당하고 값을 초기화한다.
+ * ecc_select() - tbl[j-1] = jP (j = 1..8)인 표에서 dP (d ∈ [-8, 8], d != 0)를 골라 T에 넣는다.
+ * 표 전체를 d와 무관하게 읽어 분기 없이 고르므로 접근 위치로 d가 드러나지 않는다.
  */
-void ecdsa_p256_init(void)
+static void ecc_select(ecc_affine_t *T, const ecc_affine_t *tbl, int d)
 {
-    mpz_t g_x, g_y;
-    mpz_inits(g_x, g_y, NULL);
+    int j, neg = d < 0, abs = neg ? -d : d;
+    p256_fe negy;
 
-    mpz_set_str(p, "FFFFFFFF00000001000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFF", 16);
-    mpz_set_str(n, "FFFFFFFF00000000FFFFFFFFFFFFFFFFBCE6FAADA7179E84F3B9CAC2FC632551", 16);
-    mpz_set_str(g_x, "6b17d1f2e12c4247f8bce6e563a440f277037d812deb33a0f4a13945d898c296", 16);
-    mpz_set_str(g_y, "4fe342e2fe1a7f9b8ee7eb4a7c0f9e162bce33576b315ececbb6406837bf51f5", 16);
+    *T = tbl[0];
+    for (j = 1; j < ECC_COMB_POINTS; j++) {
+        p256_fe_cmov(T->x, tbl[j].x, j + 1 == abs);
+        p256_fe_cmov(T->y, tbl[j].y, j + 1 == abs);
+    }
+    p256_fe_neg(negy, T->y);
+    p256_fe_cmov(T->y, negy, neg);
+}
 
-    mpz_export(G.x, NULL, 1, ECDSA_P256/8, 1, 0, g_x);
-    mpz_export(G.y, NULL, 1, ECDSA_P256/8, 1, 0, g_y);
+/*
+ * ecc_add_complete() - 동차 사영 좌표에서 P = P + Q를 계산한다. Q는 아핀 좌표의 점이다.
+ * a = -3인 곡선의 Renes-Costello-Batina 완전 덧셈 공식(2015/1060의 알고리즘 5)으로,
+ * P = O, P = Q, P = -Q를 포함한 모든 입력에 같은 연산 순서로 올바른 값을 낸다.
+ * 곱셈 11번과 b와의 곱셈 2번을 하며 점의 값에 따른 분기가 없다.
+ */
+static void ecc_add_complete(ecc_proj_t *P, const ecc_affine_t *Q)
+{
+    p256_fe t0, t1, t2, t3, t4, X3, Y3, Z3;
 
-    mpz_clears(g_x, g_y, NULL);
+    p256_fe_mul(t0, P->X, Q->x);
+    p256_fe_mul(t1, P->Y, Q->y);
+    p256_fe_add(t3, Q->x, Q->y);
+    p256_fe_add(t4, P->X, P->Y);
+    p256_fe_mul(t3, t3, t4);
+    p256_fe_add(t4, t0, t1);
+    p256_fe_sub(t3, t3, t4);            // t3 = X1*y2 + Y1*x2
+    p256_fe_mul(t4, Q->y, P->Z);
+    p256_fe_add(t4, t4, P->Y);          // t4 = Y1 + y2*Z1
+    p256_fe_mul(Y3, Q->x, P->Z);
+    p256_fe_add(Y3, Y3, P->X);          // Y3 = X1 + x2*Z1
+    p256_fe_mul(Z3, B, P->Z);
+    p256_fe_sub(X3, Y3, Z3);
+    p256_fe_add(Z3, X3, X3);
+    p256_fe_add(X3, X3, Z3);
+    p256_fe_sub(Z3, t1, X3);
+    p256_fe_add(X3, t1, X3);
+    p256_fe_mul(Y3, B, Y3);
+    p256_fe_add(t1, P->Z, P->Z);
+    p256_fe_add(t2, t1, P->Z);          // t2 = 3*Z1
+    p256_fe_sub(Y3, Y3, t2);
+    p256_fe_sub(Y3, Y3, t0);
+    p256_fe_add(t1, Y3, Y3);
+    p256_fe_add(Y3, t1, Y3);
+    p256_fe_add(t1, t0, t0);
+    p256_fe_add(t0, t1, t0);
+    p256_fe_sub(t0, t0, t2);
+    p256_fe_mul(t1, t4, Y3);
+    p256_fe_mul(t2, t0, Y3);
+    p256_fe_mul(Y3, X3, Z3);
+    p256_fe_add(P->Y, Y3, t2);
+    p256_fe_mul(X3, t3, X3);
+    p256_fe_sub(P->X, X3, t1);
+    p256_fe_mul(Z3, t4, Z3);
+    p256_fe_mul(t1, t3, t0);
+    p256_fe_add(P->Z, Z3, t1);
 }
 
 /*
- * Clear 256 bit ECDSA parameters
- * 할당된 파라미터 공간을 반납한다.
+ * ecc_proj_doubling() - 동차 사영 좌표에서 P = 2P를 계산한다. a = -3인 곡선의 Renes-Costello-Batina
+ * 완전 두배 공식(2015/1060의 알고리즘 6)으로, P = O를 포함한 모든 입력에 같은 연산 순서로 계산한다.
  */
-void ecdsa_p256_clear(void)
+static void ecc_proj_doubling(ecc_proj_t *P)
+{
+    p256_fe t0, t1, t2, t3, X3, Y3, Z3;
+
+    p256_fe_sqr(t0, P->X);
+    p256_fe_sqr(t1, P->Y);
+    p256_fe_sqr(t2, P->Z);
+    p256_fe_mul(t3, P->X, P->Y);
+    p256_fe_add(t3, t3, t3);
+    p256_fe_mul(Z3, P->X, P->Z);
+    p256_fe_add(Z3, Z3, Z3);
+    p256_fe_mul(Y3, B, t2);
+    p256_fe_sub(Y3, Y3, Z3);
+    p256_fe_add(X3, Y3, Y3);
+    p256_fe_add(Y3, X3, Y3);
+    p256_fe_sub(X3, t1, Y3);
+    p256_fe_add(Y3, t1, Y3);
+    p256_fe_mul(Y3, X3, Y3);
+    p256_fe_mul(X3, X3, t3);
+    p256_fe_add(t3, t2, t2);
+    p256_fe_add(t2, t2, t3);
+    p256_fe_mul(Z3, B, Z3);
+    p256_fe_sub(Z3, Z3, t2);
+    p256_fe_sub(Z3, Z3, t0);
+    p256_fe_add(t3, Z3, Z3);
+    p256_fe_add(Z3, Z3, t3);
+    p256_fe_add(t3, t0, t0);
+    p256_fe_add(t0, t3, t0);
+    p256_fe_sub(t0, t0, t2);
+    p256_fe_mul(t0, t0, Z3);
+    p256_fe_add(Y3, Y3, t0);
+    p256_fe_mul(t0, P->Y, P->Z);
+    p256_fe_add(t0, t0, t0);
+    p256_fe_mul(Z3, t0, Z3);
+    p256_fe_sub(P->X, X3, Z3);
+    p256_fe_mul(Z3, t0, t1);
+    p256_fe_add(Z3, Z3, Z3);
+    p256_fe_add(P->Z, Z3, Z3);
+    p256_fe_copy(P->Y, Y3);
+}
+
+// 동차 사영 좌표 (X : Y : Z)를 자코비안 좌표 (XZ, YZ^2, Z)로 바꾼다. O = (0 : 1 : 0)은 Z = 0인 점이 된다
+static void ecc_proj_to_jacobian(ecc_point_t *R, const ecc_proj_t *P)
 {
-   mpz_clears(p, n, NULL);
+    p256_fe t;
+
+    p256_fe_mul(R->X, P->X, P->Z);
+    p256_fe_sqr(t, P->Z);
+    p256_fe_mul(R->Y, P->Y, t);
+    p256_fe_copy(R->Z, P->Z);
 }
 
 /*
- * ecdsa_p256_key() - generates Q = dG
- * 사용자의 개인키와 공개키를 무작위로 생성한다.
+ * ecc_mul_base() - 문맥의 G_table을 이용해 R = kG를 계산한다.
+ * k를 부호 있는 4비트 자리수로 바꾼 뒤 각 자리수에 해당하는 점을 표에서 골라 더하기만 한다.
+ * 덧셈은 완전 덧셈 공식을 쓰고, 자리수가 0인 윈도우도 덧셈을 한 뒤 결과를 버리므로
+ * 연산 순서와 메모리 접근이 k와 무관하다.
+ */
+static void ecc_mul_base(const ecdsa_ctx_t *ctx, ecc_point_t *R, const p256_sc k)
+{
+    signed char d[ECC_COMB_WINDOWS];
+    ecc_affine_t T;
+    ecc_proj_t S, U;
+    int i, zero;
+
+    ecc_recode_signed4(d, k);
+    p256_fe_set_ui(S.X, 0);
+    p256_fe_set_ui(S.Y, 1);
+    p256_fe_set_ui(S.Z, 0);
+    for (i = 0; i < ECC_COMB_WINDOWS; i++) {
+        ecc_select(&T, ctx->G_table[i], d[i]);
+        U = S;
+        ecc_add_complete(&U, &T);
+        zero = d[i] == 0;
+        p256_fe_cmov(U.X, S.X, zero);
+        p256_fe_cmov(U.Y, S.Y, zero);
+        p256_fe_cmov(U.Z, S.Z, zero);
+        S = U;
+    }
+    ecc_proj_to_jacobian(R, &S);
+}
+
+/*
+ * 네 개의 독립인 점을 p256x4로 한꺼번에 다루는 동차 사영 좌표의 점이다.
+ * 완전 덧셈 공식에는 점의 값에 따른 분기가 없으므로 네 레인이 같은 연산 순서로 진행된다.
  */
+typedef struct {
+    p256x4_fe X, Y, Z;
+} ecc_proj_x4_t;
 
-void ecdsa_p256_key(void *d, ecdsa_p256_t *Q)
+// G_table을 4레인 곱셈용 몽고메리 형태로 옮긴다
+static void ecc_comb_x4(ecc_comb_x4_t tbl, const ecc_comb_t G_table)
 {
-   mpz_t temp_d;
-   mpz_init(temp_d);
+    int i, j;
 
-   // mpz_urandomm으로 랜덤값 temp_d 생성
-   gmp_randstate_t state;
-   gmp_randinit_default(state);
-   gmp_randseed_ui(state, arc4random());
-   mpz_urandomm(temp_d, state, n);
+    p256x4_init();
+    for (i = 0; i < ECC_COMB_WINDOWS; i++)
+        for (j = 0; j < ECC_COMB_POINTS; j++) {
+            p256x4_elt_from_fe(tbl[i][j][0], G_table[i][j].x);
+            p256x4_elt_from_fe(tbl[i][j][1], G_table[i][j].y);
+        }
+}
 
-   // Q = d*G
-   ecdsa_p256_t temp_G;  // G값을 저장하고 계산에 이용할 임시 변수 temp_G 생성
-   memset(Q->x,0,ECDSA_P256/8);        // Q->x 초기화
-   memset(Q->y,0,ECDSA_P256/8);        // Q->y 초기화
-   memcpy(&temp_G.x,&G.x,ECDSA_P256/8); // G의 x값 복사
-   memcpy(&temp_G.y,&G.y,ECDSA_P256/8); // G의 x값 복사
-   ecc_mul(&temp_G, temp_d, Q);
-   
-   mpz_export(d, NULL, 1, ECDSA_P256/8, 1, 0, temp_d);
+// ecc_add_complete()를 네 레인에 한꺼번에 적용한다. b4는 몽고메리 형태의 b이다
+static void ecc_add_complete_x4(ecc_proj_x4_t *P, const p256x4_fe x2, const p256x4_fe y2, const p256x4_fe b4)
+{
+    p256x4_fe t0, t1, t2, t3, t4, X3, Y3, Z3;
 
-   mpz_clear(temp_d);
+    p256x4_mul(t0, P->X, x2);
+    p256x4_mul(t1, P->Y, y2);
+    p256x4_add(t3, x2, y2);
+    p256x4_add(t4, P->X, P->Y);
+    p256x4_mul(t3, t3, t4);
+    p256x4_add(t4, t0, t1);
+    p256x4_sub(t3, t3, t4);
+    p256x4_mul(t4, y2, P->Z);
+    p256x4_add(t4, t4, P->Y);
+    p256x4_mul(Y3, x2, P->Z);
+    p256x4_add(Y3, Y3, P->X);
+    p256x4_mul(Z3, b4, P->Z);
+    p256x4_sub(X3, Y3, Z3);
+    p256x4_add(Z3, X3, X3);
+    p256x4_add(X3, X3, Z3);
+    p256x4_sub(Z3, t1, X3);
+    p256x4_add(X3, t1, X3);
+    p256x4_mul(Y3, b4, Y3);
+    p256x4_add(t1, P->Z, P->Z);
+    p256x4_add(t2, t1, P->Z);
+    p256x4_sub(Y3, Y3, t2);
+    p256x4_sub(Y3, Y3, t0);
+    p256x4_add(t1, Y3, Y3);
+    p256x4_add(Y3, t1, Y3);
+    p256x4_add(t1, t0, t0);
+    p256x4_add(t0, t1, t0);
+    p256x4_sub(t0, t0, t2);
+    p256x4_mul(t1, t4, Y3);
+    p256x4_mul(t2, t0, Y3);
+    p256x4_mul(Y3, X3, Z3);
+    p256x4_add(P->Y, Y3, t2);
+    p256x4_mul(X3, t3, X3);
+    p256x4_sub(P->X, X3, t1);
+    p256x4_mul(Z3, t4, Z3);
+    p256x4_mul(t1, t3, t0);
+    p256x4_add(P->Z, Z3, t1);
 }
 
 /*
- * ecdsa_p256_sign(msg, len, d, r, s) - ECDSA Signature Generation
- * 길이가 len 바이트인 메시지 m을 개인키 d로 서명한 결과를 r, s에 저장한다.
- * sha2_ndx는 사용할 SHA-2 해시함수 색인 값으로 SHA224, SHA256, SHA384, SHA512,
- * SHA512_224, SHA512_256 중에서 선택한다. r과 s의 길이는 256비트이어야 한다.
- * 성공하면 0, 그렇지 않으면 오류 코드를 넘겨준다.
+ * ecc_mul_base_x4() - R[l] = k[l]G (l = 0..3)를 네 레인으로 함께 계산한다.
+ * ecc_mul_base()와 같은 윈도우 순서로 레인마다 G_x4에서 분기 없이 점을 골라 더하며,
+ * 자리수가 음수인 레인은 y를, 0인 레인은 덧셈 결과를 버리는 것을 레인 단위 조건부 이동으로 처리한다.
  */
-int ecdsa_p256_sign(const void *msg, size_t len, const void *d, void *_r, void *_s, int sha2_ndx)
+static void ecc_mul_base_x4(const ecdsa_ctx_t *ctx, ecc_point_t R[4], const p256_sc k[4])
 {
-   unsigned char e[SHA512_DIGEST_SIZE];
-   int h_len;
-   mpz_t temp_e, temp_d, k, r, s;
-   ecdsa_p256_t signature;
-   gmp_randstate_t state;
+    signed char d[4][ECC_COMB_WINDOWS];
+    p256x4_elt ex[4], ey[4];
+    p256x4_fe x, y, negy, zero, b4;
+    p256_fe c[4], X[4], Y[4], Z[4];
+    ecc_proj_x4_t S, U;
+    ecc_proj_t P;
+    int i, j, l, a, neg[4], skip[4];
 
-   // Step1. e = H(m). H()는 SHA-2 해시함수이다.
-   sha(msg, len, e, sha2_ndx);
-   
-   // Step2. e의 길이가 n의 길이(256비트)보다 길면 뒷 부분은 자른다. bitlen(e) ≤ bitlen(n)
-   if (sha2_ndx == SHA384 || sha2_ndx == SHA512) h_len = SHA256_DIGEST_SIZE;
-   else h_len = SHA2SIZE(sha2_ndx); // 기존 비트 수 유지
-   mpz_inits(temp_e, temp_d, k, r, s, NULL);
-   mpz_import(temp_e, h_len, 1, 1, 1, 0, e);  // 해시 길이만큼 e를 잘라서 저장
-   mpz_import(temp_d, ECDSA_P256 / 8, 1, 1, 1, 0, d);
-   
-   ecdsa_p256_t temp_G;  // G값을 저장하고 계산에 이용할 임시 변수 temp_G 선언
-   gmp_randinit_default(state);
-   gmp_randseed_ui(state, arc4random());
-   do
-   {
-      // Step3. 비밀값 k를 무작위로 선택한다. (0 < k < n)
-      mpz_urandomm(k, state, n);
+    for (l = 0; l < 4; l++) {
+        ecc_recode_signed4(d[l], k[l]);
+        p256_fe_copy(c[l], B);
+    }
+    p256x4_from_fe(b4, (const p256_fe *)c);
+    for (l = 0; l < 4; l++)
+        p256_fe_set_ui(c[l], 0);
+    p256x4_from_fe(zero, (const p256_fe *)c);
+    p256x4_copy(S.X, zero);
+    p256x4_copy(S.Z, zero);
+    for (l = 0; l < 4; l++)
+        p256_fe_set_ui(c[l], 1);
+    p256x4_from_fe(S.Y, (const p256_fe *)c);
 
-      // Step4. (x1, y1) = k*G
-      memset(signature.x, 0, ECDSA_P256 / 8);   // x1 초기화
-      memset(signature.y, 0, ECDSA_P256 / 8);   // y1 초기화
-      memcpy(&temp_G.x,&G.x,ECDSA_P256/8);       // G의 x값 복사
-      memcpy(&temp_G.y,&G.y,ECDSA_P256/8);       // G의 y값 복사
+    for (i = 0; i < ECC_COMB_WINDOWS; i++) {
+        for (l = 0; l < 4; l++) {
+            neg[l] = d[l][i] < 0;
+            skip[l] = d[l][i] == 0;
+            a = neg[l] ? -d[l][i] : d[l][i];
+            memcpy(ex[l], ctx->G_x4[i][0][0], sizeof(p256x4_elt));
+            memcpy(ey[l], ctx->G_x4[i][0][1], sizeof(p256x4_elt));
+            for (j = 1; j < ECC_COMB_POINTS; j++) {
+                p256x4_elt_cmov(ex[l], ctx->G_x4[i][j][0], j + 1 == a);
+                p256x4_elt_cmov(ey[l], ctx->G_x4[i][j][1], j + 1 == a);
+            }
+        }
+        p256x4_load(x, (const p256x4_elt *)ex);
+        p256x4_load(y, (const p256x4_elt *)ey);
+        p256x4_sub(negy, zero, y);
+        p256x4_cmov(y, negy, neg);
+        U = S;
+        ecc_add_complete_x4(&U, x, y, b4);
+        p256x4_cmov(U.X, S.X, skip);
+        p256x4_cmov(U.Y, S.Y, skip);
+        p256x4_cmov(U.Z, S.Z, skip);
+        S = U;
+    }
 
-      ecc_mul(&temp_G, k, &signature);   // (x1, y1) 생성
+    p256x4_to_fe(X, S.X);
+    p256x4_to_fe(Y, S.Y);
+    p256x4_to_fe(Z, S.Z);
+    for (l = 0; l < 4; l++) {
+        p256_fe_copy(P.X, X[l]);
+        p256_fe_copy(P.Y, Y[l]);
+        p256_fe_copy(P.Z, Z[l]);
+        ecc_proj_to_jacobian(&R[l], &P);
+    }
+}
 
-      // Step5. r = x1 mod n
-      mpz_import(r, ECDSA_P256 / 8, 1, 1, 1, 0, signature.x);
-      mpz_mod(r, r, n);
+// CPU가 AVX2를 지원하면 네 레인으로, 그렇지 않으면 ecc_mul_base()를 네 번 불러 R[l] = k[l]G를 구한다
+static void ecc_mul_base4(const ecdsa_ctx_t *ctx, ecc_point_t R[4], const p256_sc k[4])
+{
+    int l;
 
-      // Step6. s = k^-1 * (e + rd) mod n
-      mpz_invert(k, k, n);    // k = k^-1
-      mpz_mul(temp_d, r, temp_d);     // temp_d = r*d
-      mpz_add(temp_d, temp_e, temp_d);    // temp_d = e + r*d
-      mpz_mul(s, k, temp_d);      // s = k^-1 * (e + rd)
-      mpz_mod(s, s, n);       // s = k^-1 * (e + rd) mod n
+    if (p256x4_has_avx2()) {
+        ecc_mul_base_x4(ctx, R, k);
+        return;
+    }
+    for (l = 0; l < 4; l++)
+        ecc_mul_base(ctx, &R[l], k[l]);
+}
 
-   } while (mpz_cmp_ui(r, 0) == 0 || mpz_cmp_ui(s, 0) == 0);
+// 부호 있는 자리수 d에 해당하는 점을 tbl[|d|-1]에서 골라 R에 더한다. 공개된 값에만 쓴다
+static void ecc_add_comb(ecc_point_t *R, const ecc_affine_t *tbl, int d)
+{
+    ecc_affine_t A;
 
-   mpz_export(_r, NULL, 1, ECDSA_P256 / 8, 1, 0, r);
-   mpz_export(_s, NULL, 1, ECDSA_P256 / 8, 1, 0, s);
+    if (d > 0)
+        ecc_add_affine(R, &tbl[d-1]);
+    else if (d < 0) {
+        A = tbl[-d-1];
+        p256_fe_neg(A.y, A.y);
+        ecc_add_affine(R, &A);
+    }
+}
 
-   mpz_clears(temp_e, temp_d, k, r, s, NULL);
+/*
+ * ecc_mul_comb2() - R = u1*G + u2*Q를 G_table과 캐시에 있는 Q의 표 Q_table로 계산한다.
+ * 두 스칼라 모두 두배 연산 없이 표 조회와 덧셈 최대 65번씩으로 끝난다.
+ * 검증에서만 쓰므로 표는 자리수로 바로 조회한다.
+ */
+static void ecc_mul_comb2(const ecdsa_ctx_t *ctx, ecc_point_t *R, const p256_sc u1, ecc_comb_t Q_table, const p256_sc u2)
+{
+    signed char d1[ECC_COMB_WINDOWS], d2[ECC_COMB_WINDOWS];
+    int i;
 
-   return 0;
+    ecc_recode_signed4(d1, u1);
+    ecc_recode_signed4(d2, u2);
+    p256_fe_set_ui(R->Z, 0);
+    for (i = 0; i < ECC_COMB_WINDOWS; i++) {
+        ecc_add_comb(R, ctx->G_table[i], d1[i]);
+        ecc_add_comb(R, Q_table[i], d2[i]);
+    }
 }
 
 /*
- * ecdsa_p256_verify(msg, len, Q, r, s) - ECDSA signature veryfication
- * It returns 0 if valid, nonzero otherwise.
- * 길이가 len 바이트인 메시지 m에 대한 서명이 (r,s)가 맞는지 공개키 Q로 검증한다.
- * 성공하면 0, 그렇지 않으면 오류 코드를 넘겨준다.
+ * ecc_wnaf() - k를 폭 w의 NAF로 바꾼다. k = Σ naf_i * 2^i이고 0이 아닌 naf_i는
+ * (-2^(w-1), 2^(w-1)) 범위의 홀수이다. 가장 높은 0이 아닌 자리의 위치 + 1을 반환한다.
+ * 아래 비트부터 w비트씩 읽으며, 창의 값이 2^(w-1) 이상이면 2^w를 빼고 올림을 다음 창으로 넘긴다.
  */
-int ecdsa_p256_verify(const void *msg, size_t len, const ecdsa_p256_t *_Q, const void *_r, const void *_s, int sha2_ndx)
+static int ecc_wnaf(signed char naf[ECC_WNAF_BITS], const p256_sc k, int w)
 {
-   // m의 길이가 hash function의 최대크기(2^61-1)보다 클 경우 오류 반환
-   if (len>0x1fffffffffffffff)
-       return ECDSA_MSG_TOO_LONG;
-   
-   unsigned char e[SHA512_DIGEST_SIZE];
-   int h_len;
-   mpz_t r, s, temp_e, temp, w, u1, u2, x1, v;
-   ecdsa_p256_t u1G, u2Q, XY;
+    int bit = 0, len = 0, carry = 0, now, word, shift;
 
-   mpz_inits(r, s, temp_e, w, temp, u1, u2, x1, v, NULL);
-   mpz_import(r, ECDSA_P256/8, 1, 1, 1, 0, _r);
-   mpz_import(s, ECDSA_P256/8, 1, 1, 1, 0, _s);
+    memset(naf, 0, ECC_WNAF_BITS);
+    while (bit < ECDSA_P256) {
+        if ((int)((k[bit/64] >> (bit%64)) & 1) == carry) {
+            bit++;
+            continue;
+        }
+        now = w;
+        if (now > ECDSA_P256 - bit)
+            now = ECDSA_P256 - bit;
+        shift = bit % 64;
+        word = (int)(k[bit/64] >> shift);
+        if (shift + now > 64)
+            word |= (int)(k[bit/64 + 1] << (64 - shift));
+        word = (word & ((1 << now) - 1)) + carry;
+        carry = (word >> (w - 1)) & 1;
+        naf[bit] = (signed char)(word - (carry << w));
+        bit += now;
+        len = bit;
+    }
+    if (carry) {
+        naf[ECDSA_P256] = 1;
+        len = ECDSA_P256 + 1;
+    }
+    return len;
+}
 
-   // Step1. r과 s가 [1,n-1] 사이에 있지 않으면 잘못된 서명이다.
-   mpz_sub_ui(temp, n, 1);
-   if (mpz_cmp_ui(r,1) < 0 || mpz_cmp(r,temp) > 0 || mpz_cmp_ui(s,1) < 0 || mpz_cmp(s,temp) > 0) return ECDSA_SIG_INVALID;
+// wNAF 자리수 d에 해당하는 점을 홀수 배수 표에서 골라 R에 더한다
+static void ecc_add_wnaf(ecc_point_t *R, const ecc_affine_t *tbl, int d)
+{
+    ecc_affine_t A;
 
-   // Step2. e=H(m) H()는 서명에서 사용한 해시함수와 같다.
-   sha(msg, len, e, sha2_ndx);
-    
-   // Step3. e의 길이가 n의 길이(256비트)보다 길면 뒷 부분을 자른다. bitlen(e) <= bitlen(n)
-   if (sha2_ndx == SHA384 || sha2_ndx == SHA512) h_len = SHA256_DIGEST_SIZE;
-   else h_len=SHA2SIZE(sha2_ndx);
-   mpz_import(temp_e, h_len, 1, 1, 1, 0, e);  // 해시 길이만큼 e를 잘라서 저장
+    if (d > 0)
+        ecc_add_affine(R, &tbl[(d-1)/2]);
+    else if (d < 0) {
+        A = tbl[(-d-1)/2];
+        p256_fe_neg(A.y, A.y);
+        ecc_add_affine(R, &A);
+    }
+}
 
-   // Step4. u1 = es^-1 mod n, u2 = rs^-1 mod n
-   mpz_invert(w, s, n);  // w = s^-1 mod n
-   mpz_mul(u1, temp_e, w);   // u1 = e*s^-1
-   mpz_mul(u2, r, w);    // u2 = r*s^-1
-   mpz_mod(u1, u1, n);   // u1 = u1 mod n
-   mpz_mod(u2, u2, n);   // u2 = u2 mod n
+/*
+ * ecc_mul_joint() - R = u1*G + u2*Q를 Straus-Shamir 방식으로 계산한다.
+ * 두 스칼라를 각각 wNAF로 바꾼 뒤 위 자리부터 R = 2R + naf1_i*G + naf2_i*Q를 반복하므로
+ * 두배 연산을 두 스칼라가 함께 쓴다. G의 홀수 배수는 미리 만든 폭 7의 G_odd를 쓰고,
+ * Q의 홀수 배수 Q, 3Q, ..., 15Q만 호출마다 만들어 한 번의 역원으로 아핀 좌표로 바꾼다.
+ * 덧셈은 대략 256/8 + 256/6번이다.
+ */
+static void ecc_mul_joint(const ecdsa_ctx_t *ctx, ecc_point_t *R, const p256_sc u1, const ecc_point_t *Q, const p256_sc u2)
+{
+    signed char naf1[ECC_WNAF_BITS], naf2[ECC_WNAF_BITS];
+    ecc_affine_t Q_odd[ECC_WNAF_POINTS(ECC_WNAF_W)];
+    int i, len1, len2;
 
-   // Step5. (x1, y1) = u1G + u2Q.만일 (x1, y1) = O이면 잘못된 서명이다.
-   ecdsa_p256_t temp_G;  // G값을 저장하고 계산에 이용할 임시 변수 temp_G 선언
-   ecdsa_p256_t temp_Q;  // Q값을 저장하고 계산에 이용할 임시 변수 temp_Q 선언
-   memcpy(&temp_G.x,&G.x,ECDSA_P256/8);    // G의 x값 복사
-   memcpy(&temp_G.y,&G.y,ECDSA_P256/8);    // G의 y값 복사
-   memcpy(&temp_Q.x,_Q->x,ECDSA_P256/8);   // Q의 x값 복사
-   memcpy(&temp_Q.y,_Q->y,ECDSA_P256/8);   // Q의 y값 복사
-
-   // u1G, u2Q를 0으로 초기화
-   memset(u1G.x,0,ECDSA_P256/8);
-   memset(u1G.y,0,ECDSA_P256/8);
-   memset(u2Q.x,0,ECDSA_P256/8);
-   memset(u2Q.y,0,ECDSA_P256/8);
-
-   ecc_mul(&temp_G, u1, &u1G);
-   ecc_mul(&temp_Q, u2, &u2Q);
-   if (ecc_add(&u1G, &u2Q, &XY)==1)
-       return ECDSA_SIG_INVALID;
+    len1 = ecc_wnaf(naf1, u1, ECC_WNAF_G_W);
+    len2 = 0;
+    if (!p256_fe_is_zero(Q->Z)) {
+        len2 = ecc_wnaf(naf2, u2, ECC_WNAF_W);
+        if (len2 > 0)
+            ecc_odd_multiples(Q_odd, Q, ECC_WNAF_POINTS(ECC_WNAF_W));
+    }
 
-   // Step6. r = x1 (mod n)이면 올바른 서명이다.
-   mpz_import(x1, ECDSA_P256/8, 1, 1, 1, 0, XY.x);
-   mpz_mod(v, x1, n);   // v = x1 mod n
+    p256_fe_set_ui(R->Z, 0);
+    for (i = (len1 > len2 ? len1 : len2) - 1; i >= 0; i--) {
+        ecc_doubling(R);
+        if (i < len1)
+            ecc_add_wnaf(R, ctx->G_odd, naf1[i]);
+        if (i < len2)
+            ecc_add_wnaf(R, Q_odd, naf2[i]);
+    }
+}
 
-   // v!=r 이면 전자서명 인증실패
-   if(mpz_cmp(v,r)!=0)
-       return ECDSA_SIG_MISMATCH;
+// k의 pos번째 비트부터 c비트(c < 32)를 읽는다. 256비트를 넘는 부분은 0이다
+static int ecc_sc_bits(const p256_sc k, int pos, int c)
+{
+    uint64_t v;
 
-   mpz_clears(r, s, temp_e, temp, w, u1, u2, x1, v, NULL);
-   return 0;
+    if (pos >= ECDSA_P256)
+        return 0;
+    v = k[pos/64] >> (pos%64);
+    if (pos%64 + c > 64 && pos/64 < 3)
+        v |= k[pos/64 + 1] << (64 - pos%64);
+    return (int)(v & ((1u << c) - 1));
+}
+
+/*
+ * ecc_msm() - R = Σ k_i P_i (i = 0..cnt-1)를 Pippenger의 버킷 방법으로 계산한다.
+ * 스칼라를 c비트의 부호 있는 자리수 d ∈ [-2^(c-1), 2^(c-1))로 나누고, 위 창부터 R을 c번 두배한 뒤
+ * 자리수가 d인 점을 버킷 B_|d|에 (d < 0이면 y를 뒤집어) 모으고 Σ j * B_j를 누적합 두 번으로 더한다.
+ * 창마다 점 하나당 덧셈이 한 번이므로 점이 많을수록 점당 비용이 줄어든다.
+ * c는 (창의 수) * (cnt + 버킷 수)가 가장 작아지도록 고른다. 검증에서만 쓰므로 시간이 일정하지 않다.
+ * 메모리를 할당하지 못하면 -1을 반환한다.
+ */
+static int ecc_msm(ecc_point_t *R, const ecc_affine_t *P, const p256_sc *k, int cnt)
+{
+    ecc_point_t *bucket, S, T;
+    ecc_affine_t A;
+    short *d;
+    long cost, best = 0;
+    int c = 2, nb, win, i, j, w, v, carry;
+
+    for (i = 2; i <= 16; i++) {
+        cost = (long)(ECDSA_P256/i + 1) * (cnt + (1 << (i-1)));
+        if (best == 0 || cost < best) {
+            best = cost;
+            c = i;
+        }
+    }
+    nb = 1 << (c-1);
+    win = ECDSA_P256/c + 1;
+    d = malloc(cnt * win * sizeof(short));
+    bucket = malloc(nb * sizeof(ecc_point_t));
+    if (d == NULL || bucket == NULL) {
+        free(d);
+        free(bucket);
+        return -1;
+    }
+    for (i = 0; i < cnt; i++)
+        for (w = 0, carry = 0; w < win; w++) {
+            v = ecc_sc_bits(k[i], w*c, c) + carry;
+            carry = (v + nb) >> c;
+            d[i*win + w] = (short)(v - (carry << c));
+        }
+
+    p256_fe_set_ui(R->Z, 0);
+    for (w = win - 1; w >= 0; w--) {
+        for (j = 0; j < c; j++)
+            ecc_doubling(R);
+        for (j = 0; j < nb; j++)
+            p256_fe_set_ui(bucket[j].Z, 0);
+        for (i = 0; i < cnt; i++) {
+            v = d[i*win + w];
+            if (v > 0)
+                ecc_add_affine(&bucket[v-1], &P[i]);
+            else if (v < 0) {
+                A = P[i];
+                p256_fe_neg(A.y, A.y);
+                ecc_add_affine(&bucket[-v-1], &A);
+            }
+        }
+        // T = Σ j * B_j = B_nb + (B_nb + B_nb-1) + ... + (B_nb + ... + B_1)
+        p256_fe_set_ui(S.Z, 0);
+        p256_fe_set_ui(T.Z, 0);
+        for (j = nb - 1; j >= 0; j--) {
+            ecc_add(&S, &bucket[j]);
+            ecc_add(&T, &S);
+        }
+        ecc_add(R, &T);
+    }
+    free(d);
+    free(bucket);
+    return 0;
+}
+
+// Montgomery의 방법으로 s[0..cnt-1]의 역원을 한 번의 역원 계산과 곱셈 3(cnt-1)번으로 구한다. s_i는 0이 아니어야 한다
+// 메모리를 할당하지 못하면 하나씩 역원을 구한다
+static void ecc_sc_inv_batch(p256_sc *s, int cnt)
+{
+    p256_sc *t, u, v;
+    int i;
+
+    if (cnt <= 0)
+        return;
+    if ((t = malloc(cnt * sizeof(p256_sc))) == NULL) {
+        for (i = 0; i < cnt; i++)
+            p256_sc_inv(s[i], s[i]);
+        return;
+    }
+    memcpy(t[0], s[0], sizeof(p256_sc));
+    for (i = 1; i < cnt; i++)
+        p256_sc_mul(t[i], t[i-1], s[i]);    // t_i = s_0 * ... * s_i
+    p256_sc_inv(u, t[cnt-1]);
+    for (i = cnt - 1; i > 0; i--) {
+        p256_sc_mul(v, u, t[i-1]);          // s_i^-1 = (s_0 ... s_i)^-1 * (s_0 ... s_i-1)
+        p256_sc_mul(u, u, s[i]);            // u = (s_0 ... s_i-1)^-1
+        memcpy(s[i], v, sizeof(p256_sc));
+    }
+    memcpy(s[0], u, sizeof(p256_sc));
+    free(t);
+}
+
+// 항목 E를 LRU 목록에서 뗀다
+static void ecc_cache_unlink(ecc_cache_t *C, ecc_cache_entry_t *E)
+{
+    if (E->prev)
+        E->prev->next = E->next;
+    else
+        C->head = E->next;
+    if (E->next)
+        E->next->prev = E->prev;
+    else
+        C->tail = E->prev;
+}
+
+// 항목 E를 LRU 목록의 맨 앞(가장 최근)에 붙인다
+static void ecc_cache_push(ecc_cache_t *C, ecc_cache_entry_t *E)
+{
+    E->prev = NULL;
+    E->next = C->head;
+    if (C->head)
+        C->head->prev = E;
+    else
+        C->tail = E;
+    C->head = E;
+}
+
+// 가장 오래 쓰이지 않은 항목을 버킷과 목록에서 지우고 메모리를 반납한다
+static void ecc_cache_evict(ecc_cache_t *C)
+{
+    ecc_cache_entry_t *E = C->tail, **pp;
+
+    for (pp = &C->bucket[E->key.x[ECDSA_P256/8 - 1]]; *pp != E; pp = &(*pp)->chain)
+        ;
+    *pp = E->chain;
+    ecc_cache_unlink(C, E);
+    C->used -= sizeof(ecc_cache_entry_t);
+    if (E->tbl) {
+        C->used -= sizeof(ecc_comb_t);
+        free(E->tbl);
+    }
+    free(E);
+}
+
+// size바이트를 더 쓸 수 있도록 오래된 항목을 내보낸다. 한도 안에 들 수 없으면 0을 반환한다
+static int ecc_cache_reserve(ecc_cache_t *C, size_t size)
+{
+    if (size > C->budget)
+        return 0;
+    while (C->used + size > C->budget)
+        ecc_cache_evict(C);
+    return 1;
+}
+
+/*
+ * ecc_cache_get() - 캐시 C에서 공개키 A의 고정 기저 표를 캐시에서 찾는다. 표가 없으면 NULL을 반환한다.
+ * 찾은 항목은 LRU 목록의 맨 앞으로 옮긴다. 처음 보는 키는 항목만 추가하고,
+ * 사용 횟수가 ECC_CACHE_ADMIT에 이르면 Q로 표를 만든다. Q는 무한원점이 아니어야 한다.
+ */
+static ecc_comb_t *ecc_cache_get(ecc_cache_t *C, const ecdsa_p256_t *A, const ecc_point_t *Q)
+{
+    ecc_cache_entry_t *E, **bucket = &C->bucket[A->x[ECDSA_P256/8 - 1]];
+
+    for (E = *bucket; E; E = E->chain)
+        if (memcmp(&E->key, A, sizeof(ecdsa_p256_t)) == 0)
+            break;
+    if (E) {
+        ecc_cache_unlink(C, E);
+        ecc_cache_push(C, E);
+    }
+    else {
+        if (!ecc_cache_reserve(C, sizeof(ecc_cache_entry_t)) || (E = malloc(sizeof(ecc_cache_entry_t))) == NULL) {
+            C->misses++;
+            return NULL;
+        }
+        E->key = *A;
+        E->uses = 0;
+        E->tbl = NULL;
+        E->chain = *bucket;
+        *bucket = E;
+        ecc_cache_push(C, E);
+        C->used += sizeof(ecc_cache_entry_t);
+    }
+    if (E->tbl == NULL && ++E->uses >= ECC_CACHE_ADMIT) {
+        // 표를 위한 공간을 비우는 동안 E가 지워지지 않도록 잠시 목록에서 뗀다
+        ecc_cache_unlink(C, E);
+        C->used -= sizeof(ecc_cache_entry_t);
+        if (ecc_cache_reserve(C, sizeof(ecc_cache_entry_t) + sizeof(ecc_comb_t)) && (E->tbl = malloc(sizeof(ecc_comb_t))) != NULL) {
+            if (ecc_comb_table(*E->tbl, Q) == 0)
+                C->used += sizeof(ecc_comb_t);
+            else {
+                free(E->tbl);
+                E->tbl = NULL;
+            }
+        }
+        C->used += sizeof(ecc_cache_entry_t);
+        ecc_cache_push(C, E);
+        // 표를 만든 이번 검증은 캐시의 이득을 보지 못했으므로 miss로 센다
+        if (E->tbl) {
+            C->misses++;
+            return E->tbl;
+        }
+    }
+    if (E->tbl == NULL) {
+        C->misses++;
+        return NULL;
+    }
+    C->hits++;
+    return E->tbl;
+}
+
+/*
+ * ecdsa_bits2int() - RFC 6979 2.3.2의 bits2int로, in의 앞쪽 min(8*inlen, bits)비트를 정수로 읽어
+ * size 바이트의 빅 엔디안으로 out에 쓴다. in이 bits보다 길면 뒷 부분을 자르고, 짧으면 앞에 0을 채운다.
+ */
+static void ecdsa_bits2int(unsigned char *out, int size, int bits, const unsigned char *in, int inlen)
+{
+    int i, shift;
+
+    memset(out, 0, size);
+    if (8 * inlen <= bits) {
+        memcpy(out + size - inlen, in, inlen);
+        return;
+    }
+    memcpy(out, in, size);
+    if ((shift = 8 * size - bits) == 0)
+        return;
+    for (i = size - 1; i > 0; i--)
+        out[i] = (unsigned char)((out[i] >> shift) | (out[i-1] << (8 - shift)));
+    out[0] >>= shift;
+}
+
+/*
+ * ecdsa_hash() - e = H(m)을 계산하여 스칼라로 돌려준다.
+ * e의 길이가 n의 길이(256비트)보다 길면 뒷 부분은 자른다. bitlen(e) ≤ bitlen(n)
+ */
+static void ecdsa_hash(p256_sc e, const void *msg, size_t len, int sha2_ndx)
+{
+    unsigned char digest[SHA512_DIGEST_SIZE], buf[ECDSA_P256/8];
+
+    sha(msg, len, digest, sha2_ndx);
+    ecdsa_bits2int(buf, ECDSA_P256/8, ECDSA_P256, digest, SHA2SIZE(sha2_ndx));
+    p256_sc_from_bytes(e, buf);
+}
+
+// 두 바이트 배열이 같으면 1을 반환한다. 비밀 값을 비교하므로 처음 다른 위치에서 멈추지 않는다
+static int ecdsa_memeq(const unsigned char *a, const unsigned char *b, int len)
+{
+    unsigned char t = 0;
+    int i;
+
+    for (i = 0; i < len; i++)
+        t |= a[i] ^ b[i];
+    return t == 0;
+}
+
+/*
+ * rfc6979_init() - RFC 6979 3.2의 b단계부터 f단계까지 수행해 개인키 x와 h1 = bits2octets(H(m))으로
+ * HMAC-DRBG를 준비한다. 같은 x와 해시함수로 다시 서명하면 문맥에 저장해 둔 d단계의 중간 상태에서 시작한다.
+ */
+static void rfc6979_init(ecdsa_ctx_t *ctx, rfc6979_t *D, const unsigned char x[ECDSA_P256/8], const unsigned char h1[ECDSA_P256/8], int sha2_ndx)
+{
+    rfc6979_key_t *X = &ctx->nonce_key;
+    unsigned char K[SHA512_DIGEST_SIZE], b;
+    sha2_ctx_t c;
+
+    D->hlen = SHA2SIZE(sha2_ndx);
+    D->reseed = 0;
+    if (!X->valid || X->sha2_ndx != sha2_ndx || !ecdsa_memeq(X->x, x, ECDSA_P256/8)) {
+        memset(K, 0x00, D->hlen);
+        memset(D->V, 0x01, D->hlen);
+        hmac_setkey(&X->K0, sha2_ndx, K, D->hlen);
+        X->step_d = X->K0.in;
+        b = 0x00;
+        sha2_update(&X->step_d, D->V, D->hlen);
+        sha2_update(&X->step_d, &b, 1);
+        sha2_update(&X->step_d, x, ECDSA_P256/8);
+        memcpy(X->x, x, ECDSA_P256/8);
+        X->sha2_ndx = sha2_ndx;
+        X->valid = 1;
+    }
+
+    // d. K = HMAC_K(V || 0x00 || int2octets(x) || bits2octets(h1))
+    c = X->step_d;
+    sha2_update(&c, h1, ECDSA_P256/8);
+    hmac_finish(&X->K0, &c, K);
+    hmac_setkey(&D->K, sha2_ndx, K, D->hlen);
+    // e. V = HMAC_K(V)
+    memset(D->V, 0x01, D->hlen);
+    c = D->K.in;
+    sha2_update(&c, D->V, D->hlen);
+    hmac_finish(&D->K, &c, D->V);
+    // f. K = HMAC_K(V || 0x01 || int2octets(x) || bits2octets(h1))
+    c = D->K.in;
+    b = 0x01;
+    sha2_update(&c, D->V, D->hlen);
+    sha2_update(&c, &b, 1);
+    sha2_update(&c, x, ECDSA_P256/8);
+    sha2_update(&c, h1, ECDSA_P256/8);
+    hmac_finish(&D->K, &c, K);
+    hmac_setkey(&D->K, sha2_ndx, K, D->hlen);
+    // g. V = HMAC_K(V)
+    c = D->K.in;
+    sha2_update(&c, D->V, D->hlen);
+    hmac_finish(&D->K, &c, D->V);
+    memset(K, 0, sizeof(K));
+}
+
+/*
+ * rfc6979_next() - RFC 6979 3.2 h단계로 1 <= k < n인 다음 k를 만든다.
+ * 앞에서 만든 k가 쓰이지 못했으면(r = 0 또는 s = 0) K와 V를 갱신한 뒤 다시 만든다.
+ */
+static void rfc6979_next(rfc6979_t *D, p256_sc k)
+{
+    unsigned char T[ECDSA_P256/8 + SHA512_DIGEST_SIZE], K[SHA512_DIGEST_SIZE], b = 0x00;
+    sha2_ctx_t c;
+    int tlen;
+
+    for (;;) {
+        if (D->reseed) {
+            // K = HMAC_K(V || 0x00), V = HMAC_K(V)
+            c = D->K.in;
+            sha2_update(&c, D->V, D->hlen);
+            sha2_update(&c, &b, 1);
+            hmac_finish(&D->K, &c, K);
+            hmac_setkey(&D->K, D->K.in.sha2_ndx, K, D->hlen);
+            c = D->K.in;
+            sha2_update(&c, D->V, D->hlen);
+            hmac_finish(&D->K, &c, D->V);
+        }
+        D->reseed = 1;
+        for (tlen = 0; tlen < ECDSA_P256/8; tlen += D->hlen) {
+            c = D->K.in;
+            sha2_update(&c, D->V, D->hlen);
+            hmac_finish(&D->K, &c, D->V);
+            memcpy(T + tlen, D->V, D->hlen);
+        }
+        // k = bits2int(T), T의 앞 256비트
+        if (p256_sc_from_bytes(k, T) && !p256_sc_is_zero(k))
+            break;
+    }
+    memset(T, 0, sizeof(T));
+    memset(K, 0, sizeof(K));
+}
+
+// arc4random_buf()로 1 <= k < n인 난수 k를 만든다
+static void ecdsa_random_k(p256_sc k)
+{
+    unsigned char buf[ECDSA_P256/8];
+
+    do
+        arc4random_buf(buf, sizeof(buf));
+    while (!p256_sc_from_bytes(k, buf) || p256_sc_is_zero(k));
+    memset(buf, 0, sizeof(buf));
+}
+
+/*
+ * ecdsa_ctx_new() - 새 ECDSA 문맥을 만든다.
+ * G를 준비하고, kG 계산에 쓰는 G의 고정 기저 표와 검증에 쓰는 G의 홀수 배수 표를 만든다.
+ * 메모리를 할당하지 못하면 NULL을 반환한다.
+ */
+ecdsa_ctx_t *ecdsa_ctx_new(void)
+{
+    static const unsigned char g_x[ECDSA_P256/8] = {
+        0x6b,0x17,0xd1,0xf2,0xe1,0x2c,0x42,0x47,0xf8,0xbc,0xe6,0xe5,0x63,0xa4,0x40,0xf2,
+        0x77,0x03,0x7d,0x81,0x2d,0xeb,0x33,0xa0,0xf4,0xa1,0x39,0x45,0xd8,0x98,0xc2,0x96};
+    static const unsigned char g_y[ECDSA_P256/8] = {
+        0x4f,0xe3,0x42,0xe2,0xfe,0x1a,0x7f,0x9b,0x8e,0xe7,0xeb,0x4a,0x7c,0x0f,0x9e,0x16,
+        0x2b,0xce,0x33,0x57,0x6b,0x31,0x5e,0xce,0xcb,0xb6,0x40,0x68,0x37,0xbf,0x51,0xf5};
+    ecdsa_ctx_t *ctx;
+
+    if ((ctx = malloc(sizeof(ecdsa_ctx_t))) == NULL)
+        return NULL;
+    p256_fe_from_bytes(ctx->G.X, g_x);
+    p256_fe_from_bytes(ctx->G.Y, g_y);
+    p256_fe_set_ui(ctx->G.Z, 1);
+    if (ecc_comb_table(ctx->G_table, &ctx->G) != 0) {
+        free(ctx);
+        return NULL;
+    }
+    ecc_comb_x4(ctx->G_x4, ctx->G_table);
+    ecc_odd_multiples(ctx->G_odd, &ctx->G, ECC_WNAF_POINTS(ECC_WNAF_G_W));
+    memset(&ctx->cache, 0, sizeof(ecc_cache_t));
+    ctx->cache.budget = ECDSA_CACHE_BUDGET;
+    memset(&ctx->nonce_key, 0, sizeof(rfc6979_key_t));
+    return ctx;
+}
+
+/*
+ * ecdsa_ctx_free() - 문맥과 문맥이 가진 캐시를 반납한다.
+ */
+void ecdsa_ctx_free(ecdsa_ctx_t *ctx)
+{
+    if (ctx == NULL)
+        return;
+    while (ctx->cache.tail)
+        ecc_cache_evict(&ctx->cache);
+    memset(&ctx->nonce_key, 0, sizeof(rfc6979_key_t));
+    free(ctx);
+}
+
+/*
+ * ecdsa_ctx_cache_budget() - 공개키 캐시가 쓸 수 있는 메모리 한도를 바이트 단위로 정한다.
+ * 한도를 줄이면 오래된 항목부터 바로 내보내며, 0이면 캐시를 쓰지 않는다.
+ * 공개키 하나의 표는 약 33KB이다.
+ */
+void ecdsa_ctx_cache_budget(ecdsa_ctx_t *ctx, size_t bytes)
+{
+    ctx->cache.budget = bytes;
+    while (ctx->cache.used > ctx->cache.budget)
+        ecc_cache_evict(&ctx->cache);
+}
+
+/*
+ * ecdsa_ctx_cache_stats() - 검증에서 캐시에 있는 표를 쓴 횟수(hits)와 쓰지 못한 횟수(misses)를 돌려준다.
+ */
+void ecdsa_ctx_cache_stats(const ecdsa_ctx_t *ctx, unsigned long *hits, unsigned long *misses)
+{
+    *hits = ctx->cache.hits;
+    *misses = ctx->cache.misses;
+}
+
+/*
+ * ecdsa_ctx_key() - generates Q = dG
+ * 사용자의 개인키와 공개키를 무작위로 생성한다.
+ */
+
+void ecdsa_ctx_key(ecdsa_ctx_t *ctx, void *d, ecdsa_p256_t *Q)
+{
+   p256_sc temp_d;
+   ecc_point_t R;
+
+   // 1 <= temp_d < n인 랜덤값 temp_d 생성
+   ecdsa_random_k(temp_d);
+
+   // Q = d*G
+   ecc_mul_base(ctx, &R, temp_d);
+   ecc_normalize(&R);
+   ecc_point_export(Q, &R);
+   
+   p256_sc_to_bytes(d, temp_d);
+   memset(temp_d, 0, sizeof(temp_d));
+}
+
+/*
+ * ecdsa_ctx_key_x4() - generates four key pairs Q[l] = d[l]G
+ * 개인키와 공개키 네 쌍을 한꺼번에 만든다. 네 스칼라 곱셈은 AVX2가 있으면 4레인으로 함께 진행된다.
+ */
+void ecdsa_ctx_key_x4(ecdsa_ctx_t *ctx, void *d[4], ecdsa_p256_t Q[4])
+{
+   p256_sc temp_d[4];
+   ecc_point_t R[4];
+   int l;
+
+   for (l = 0; l < 4; l++)
+      ecdsa_random_k(temp_d[l]);
+   ecc_mul_base4(ctx, R, (const p256_sc *)temp_d);
+   ecc_normalize_batch(R, 4);
+   for (l = 0; l < 4; l++) {
+      ecc_point_export(&Q[l], &R[l]);
+      p256_sc_to_bytes(d[l], temp_d[l]);
+   }
+   memset(temp_d, 0, sizeof(temp_d));
+}
+
+/*
+ * ecdsa_ctx_sign(ctx, msg, len, d, r, s) - ECDSA Signature Generation
+ * 길이가 len 바이트인 메시지 m을 개인키 d로 서명한 결과를 r, s에 저장한다.
+ * sha2_ndx는 사용할 SHA-2 해시함수 색인 값으로 SHA224, SHA256, SHA384, SHA512,
+ * SHA512_224, SHA512_256 중에서 선택한다. r과 s의 길이는 256비트이어야 한다.
+ * k는 RFC 6979에 따라 d와 H(m)으로부터 HMAC-DRBG로 만들므로 같은 입력에는 항상 같은 서명이 나온다.
+ * 성공하면 0, 그렇지 않으면 오류 코드를 넘겨준다.
+ */
+int ecdsa_ctx_sign(ecdsa_ctx_t *ctx, const void *msg, size_t len, const void *d, void *_r, void *_s, int sha2_ndx)
+{
+   return ecdsa_ctx_sign_recid(ctx, msg, len, d, _r, _s, NULL, sha2_ndx);
+}
+
+/*
+ * ecdsa_ctx_sign_recid(ctx, msg, len, d, r, s, recid) - ecdsa_ctx_sign()과 같은 서명을 만들고
+ * ecdsa_p256_recover()로 공개키를 복원할 때 쓰는 복원 색인을 recid에 저장한다(NULL이면 저장하지 않는다).
+ * recid의 비트 0은 R의 y의 홀짝, 비트 1은 x1 >= n 여부이다.
+ */
+int ecdsa_ctx_sign_recid(ecdsa_ctx_t *ctx, const void *msg, size_t len, const void *d, void *_r, void *_s, int *recid, int sha2_ndx)
+{
+   unsigned char x1[ECDSA_P256/8], x[ECDSA_P256/8], h1[ECDSA_P256/8];
+   p256_sc e, temp_d, k, r, s;
+   ecc_point_t R;
+   rfc6979_t drbg;
+   int overflow;
+   STAT_DECL;
+
+   STAT_BEGIN(STAT_SIGN);
+   // Step1, Step2. e = H(m)을 n의 길이에 맞게 자른다.
+   ecdsa_hash(e, msg, len, sha2_ndx);
+   STAT_LAP(STAT_SIGN, ECDSA_STAT_HASH);
+   p256_sc_from_bytes(temp_d, d);
+
+   // RFC 6979의 int2octets(x)와 bits2octets(h1)은 d mod n과 e를 바이트로 쓴 것과 같다
+   p256_sc_to_bytes(x, temp_d);
+   p256_sc_to_bytes(h1, e);
+   STAT_LAP(STAT_SIGN, ECDSA_STAT_MISC);
+   rfc6979_init(ctx, &drbg, x, h1, sha2_ndx);
+   
+   do
+   {
+      // Step3. 비밀값 k를 RFC 6979로 만든다. (0 < k < n)
+      rfc6979_next(&drbg, k);
+      STAT_LAP(STAT_SIGN, ECDSA_STAT_HASH);
+
+      // Step4. (x1, y1) = k*G
+      ecc_mul_base(ctx, &R, k);   // (x1, y1) 생성
+      STAT_LAP(STAT_SIGN, ECDSA_STAT_MUL);
+      ecc_normalize(&R);
+      STAT_LAP(STAT_SIGN, ECDSA_STAT_INV);
+
+      // Step5. r = x1 mod n. x1 >= n이면 복원할 때 x1 = r + n으로 되돌려야 한다
+      p256_fe_to_bytes(x1, R.X);
+      overflow = !p256_sc_from_bytes(r, x1);
+      STAT_LAP(STAT_SIGN, ECDSA_STAT_MISC);
+
+      // Step6. s = k^-1 * (e + rd) mod n
+      p256_sc_inv(k, k);    // k = k^-1
+      STAT_LAP(STAT_SIGN, ECDSA_STAT_INV);
+      p256_sc_mul(s, r, temp_d);     // s = r*d
+      p256_sc_add(s, e, s);    // s = e + r*d
+      p256_sc_mul(s, k, s);      // s = k^-1 * (e + rd) mod n
+
+   } while (p256_sc_is_zero(r) || p256_sc_is_zero(s));
+
+   p256_sc_to_bytes(_r, r);
+   p256_sc_to_bytes(_s, s);
+   if (recid != NULL)
+       *recid = overflow << 1 | (int)(R.Y[0] & 1);
+   // k^-1은 공개된 r, s, e와 함께 d를 드러내므로 d와 함께 스택에서 지운다
+   memset(&drbg, 0, sizeof(drbg));
+   memset(x, 0, sizeof(x));
+   memset(h1, 0, sizeof(h1));
+   memset(k, 0, sizeof(k));
+   memset(e, 0, sizeof(e));
+   memset(temp_d, 0, sizeof(temp_d));
+   STAT_LAP(STAT_SIGN, ECDSA_STAT_MISC);
+
+   return 0;
+}
+
+/*
+ * ecdsa_ctx_sign_batch(ctx, msgs, lens, d, rs, ss, count) - count개의 메시지를 같은 개인키 d로 서명한다.
+ * 결과는 메시지마다 ecdsa_ctx_sign()을 부른 것과 같다. k_i G를 자코비안 좌표로 모두 계산한 뒤
+ * Montgomery의 방법으로 한꺼번에 아핀 좌표로 바꾸고, k_i^-1 mod n도 같은 방법으로 한꺼번에 구하므로
+ * 2*count번의 역원 계산이 역원 2번과 곱셈 약 6*count번으로 바뀐다.
+ * 작업 공간을 할당하지 못하면 메시지마다 ecdsa_ctx_sign()으로 서명한다.
+ * 성공하면 0, 그렇지 않으면 오류 코드를 넘겨준다.
+ */
+int ecdsa_ctx_sign_batch(ecdsa_ctx_t *ctx, const void *msgs[], const size_t lens[], const void *d, void *rs[], void *ss[], int count, int sha2_ndx)
+{
+    unsigned char x1[ECDSA_P256/8], x[ECDSA_P256/8], h1[ECDSA_P256/8];
+    p256_sc temp_d, *e, *k, r, s;
+    ecc_point_t *R;
+    rfc6979_t drbg;
+    int i;
+
+    if (count <= 0)
+        return 0;
+    e = malloc(count * sizeof(p256_sc));
+    k = malloc(count * sizeof(p256_sc));
+    R = malloc(count * sizeof(ecc_point_t));
+    if (e == NULL || k == NULL || R == NULL) {
+        free(e);
+        free(k);
+        free(R);
+        for (i = 0; i < count; i++)
+            ecdsa_ctx_sign(ctx, msgs[i], lens[i], d, rs[i], ss[i], sha2_ndx);
+        return 0;
+    }
+    p256_sc_from_bytes(temp_d, d);
+    p256_sc_to_bytes(x, temp_d);
+
+    // e_i = H(m_i), k_i는 RFC 6979로 만들고 R_i = k_i G는 자코비안 좌표로 둔다
+    for (i = 0; i < count; i++) {
+        ecdsa_hash(e[i], msgs[i], lens[i], sha2_ndx);
+        p256_sc_to_bytes(h1, e[i]);
+        rfc6979_init(ctx, &drbg, x, h1, sha2_ndx);
+        rfc6979_next(&drbg, k[i]);
+    }
+    // 서로 독립인 k_i G는 네 개씩 묶어 계산한다
+    for (i = 0; i + 4 <= count; i += 4)
+        ecc_mul_base4(ctx, R + i, (const p256_sc *)k + i);
+    for (; i < count; i++)
+        ecc_mul_base(ctx, &R[i], k[i]);
+    ecc_normalize_batch(R, count);
+    ecc_sc_inv_batch(k, count);
+
+    for (i = 0; i < count; i++) {
+        p256_fe_to_bytes(x1, R[i].X);
+        p256_sc_from_bytes(r, x1);
+        p256_sc_mul(s, r, temp_d);          // s = r*d
+        p256_sc_add(s, e[i], s);            // s = e + r*d
+        p256_sc_mul(s, k[i], s);            // s = k^-1 * (e + rd) mod n
+        // r = 0 또는 s = 0이면 RFC 6979의 다음 k가 필요하므로 하나만 따로 서명한다
+        if (p256_sc_is_zero(r) || p256_sc_is_zero(s)) {
+            ecdsa_ctx_sign(ctx, msgs[i], lens[i], d, rs[i], ss[i], sha2_ndx);
+            continue;
+        }
+        p256_sc_to_bytes(rs[i], r);
+        p256_sc_to_bytes(ss[i], s);
+    }
+
+    memset(k, 0, count * sizeof(p256_sc));
+    memset(&drbg, 0, sizeof(drbg));
+    memset(x, 0, sizeof(x));
+    memset(temp_d, 0, sizeof(temp_d));
+    free(e);
+    free(k);
+    free(R);
+    return 0;
+}
+
+/*
+ * ecdsa_ctx_verify(ctx, msg, len, Q, r, s) - ECDSA signature veryfication
+ * It returns 0 if valid, nonzero otherwise.
+ * 길이가 len 바이트인 메시지 m에 대한 서명이 (r,s)가 맞는지 공개키 Q로 검증한다.
+ * Q의 좌표가 p보다 작고 곡선 위에 있어야 하며, 그렇지 않으면 ECDSA_POINT_INVALID를 반환한다.
+ * 성공하면 0, 그렇지 않으면 오류 코드를 넘겨준다.
+ */
+int ecdsa_ctx_verify(ecdsa_ctx_t *ctx, const void *msg, size_t len, const ecdsa_p256_t *_Q, const void *_r, const void *_s, int sha2_ndx)
+{
+   // m의 길이가 hash function의 최대크기(2^61-1)보다 클 경우 오류 반환
+   if (len>0x1fffffffffffffff)
+       return ECDSA_MSG_TOO_LONG;
+   
+   unsigned char x1[ECDSA_P256/8];
+   p256_sc r, s, e, w, u1, u2, v;
+   ecc_point_t Q, R;
+   ecc_comb_t *Q_table;
+   int eq;
+   STAT_DECL;
+
+   STAT_BEGIN(STAT_VERIFY);
+   // Step1. r과 s가 [1,n-1] 사이에 있지 않으면 잘못된 서명이다.
+   if (!p256_sc_from_bytes(r, _r) || !p256_sc_from_bytes(s, _s) || p256_sc_is_zero(r) || p256_sc_is_zero(s))
+       return ECDSA_SIG_INVALID;
+   // 공개키 캐시는 Q의 바이트로 찾으므로, 올바르지 않은 Q로 표를 만들거나 찾지 않도록 먼저 확인한다
+   if (!p256_fe_from_bytes(Q.X, _Q->x) || !p256_fe_from_bytes(Q.Y, _Q->y) || !ecc_on_curve(Q.X, Q.Y))
+       return ECDSA_POINT_INVALID;
+   p256_fe_set_ui(Q.Z, 1);
+   STAT_LAP(STAT_VERIFY, ECDSA_STAT_MISC);
+
+   // Step2, Step3. e=H(m)을 n의 길이에 맞게 자른다. H()는 서명에서 사용한 해시함수와 같다.
+   ecdsa_hash(e, msg, len, sha2_ndx);
+   STAT_LAP(STAT_VERIFY, ECDSA_STAT_HASH);
+
+   // Step4. u1 = es^-1 mod n, u2 = rs^-1 mod n
+   p256_sc_inv(w, s);        // w = s^-1 mod n
+   STAT_LAP(STAT_VERIFY, ECDSA_STAT_INV);
+   p256_sc_mul(u1, e, w);    // u1 = e*s^-1 mod n
+   p256_sc_mul(u2, r, w);    // u2 = r*s^-1 mod n
+
+   // Step5. (x1, y1) = u1G + u2Q.만일 (x1, y1) = O이면 잘못된 서명이다.
+   // 자주 쓰이는 공개키는 캐시에 있는 Q의 고정 기저 표를 쓴다
+   if ((Q_table = ecc_cache_get(&ctx->cache, _Q, &Q)) != NULL)
+       ecc_mul_comb2(ctx, &R, u1, *Q_table, u2);
+   else
+       ecc_mul_joint(ctx, &R, u1, &Q, u2);
+   STAT_LAP(STAT_VERIFY, ECDSA_STAT_MUL);
+   ecc_normalize(&R);
+   STAT_LAP(STAT_VERIFY, ECDSA_STAT_INV);
+   if (p256_fe_is_zero(R.Z))
+       return ECDSA_SIG_INVALID;
+
+   // Step6. r = x1 (mod n)이면 올바른 서명이다.
+   p256_fe_to_bytes(x1, R.X);
+   p256_sc_from_bytes(v, x1);   // v = x1 mod n
+   STAT_LAP(STAT_VERIFY, ECDSA_STAT_MISC);
+
+   // v!=r 이면 전자서명 인증실패
+   eq = p256_sc_equal(v, r);
+   STAT_LAP(STAT_VERIFY, ECDSA_STAT_CMP);
+   if (!eq)
+       return ECDSA_SIG_MISMATCH;
+
+   return 0;
+}
+
+// 곡선의 위수 n. 서명의 r로부터 x1 = r + n을 만들 때 쓴다
+static const uint64_t ECC_ORDER[4] = {
+    0xf3b9cac2fc632551ULL, 0xbce6faada7179e84ULL, 0xffffffffffffffffULL, 0xffffffff00000000ULL
+};
+
+/*
+ * 일괄 검증에서 묶음에 넣은 서명들의 자료이다. j번째 서명(원래 순서로 idx[j])은 128비트 난수 a로
+ * G의 계수 g[j] = a*u1과 두 항 k[2j]*P[2j] = (a*u2)*Q, k[2j+1]*P[2j+1] = a*(-R)을 갖는다.
+ */
+typedef struct {
+    ecdsa_ctx_t *ctx;
+    const void **msgs;
+    const size_t *lens;
+    const ecdsa_p256_t *Qs;
+    const void **rs, **ss;
+    int sha2_ndx;
+    int *idx;
+    p256_sc *g, *k;
+    ecc_affine_t *P;
+} ecdsa_batch_t;
+
+// 이보다 적은 수의 서명은 묶어서 확인하는 것보다 하나씩 검증하는 편이 빠르다
+#define ECDSA_BATCH_MIN 4
+
+// 묶음의 [lo, hi) 범위에 대해 Σ g_j G + Σ k_i P_i = O이면 1, 아니면 0, 메모리를 할당하지 못하면 -1을 반환한다
+static int ecdsa_batch_check(const ecdsa_batch_t *b, int lo, int hi)
+{
+    p256_sc g;
+    ecc_point_t R, T;
+    int j;
+
+    memset(g, 0, sizeof(p256_sc));
+    for (j = lo; j < hi; j++)
+        p256_sc_add(g, g, b->g[j]);
+    ecc_mul_base(b->ctx, &R, g);
+    if (ecc_msm(&T, b->P + 2*lo, (const p256_sc *)b->k + 2*lo, 2*(hi - lo)) != 0)
+        return -1;
+    ecc_add(&R, &T);
+    return p256_fe_is_zero(R.Z);
+}
+
+// 묶음의 [lo, hi) 범위를 ecdsa_p256_verify()로 하나씩 검증해 정확한 오류 코드를 얻는다
+static void ecdsa_batch_each(const ecdsa_batch_t *b, int lo, int hi, int results[])
+{
+    int j, i;
+
+    for (j = lo; j < hi; j++) {
+        i = b->idx[j];
+        results[i] = ecdsa_ctx_verify(b->ctx, b->msgs[i], b->lens[i], &b->Qs[i], b->rs[i], b->ss[i], b->sha2_ndx);
+    }
+}
+
+/*
+ * ecdsa_batch_bisect() - 묶음의 [lo, hi) 범위를 검증해 results에 결과를 넣는다.
+ * 식이 성립하지 않으면 반으로 나누어 한쪽이 성립하면 다른 쪽만 다시 나눈다. 두 반쪽이 모두 실패하면
+ * 실패한 서명이 여럿 흩어져 있거나 R의 y 홀짝을 잘못 짐작한 서명이 섞여 있다는 뜻이므로 더 나누지 않고
+ * 하나씩 검증한다. 서명이 ECDSA_BATCH_MIN개보다 적게 남거나 확인할 메모리가 없어도 하나씩 검증한다.
+ * bad가 1이면 이 범위가 실패한다는 것을 이미 알고 있으므로 확인을 건너뛴다.
+ */
+static void ecdsa_batch_bisect(const ecdsa_batch_t *b, int lo, int hi, int bad, int results[])
+{
+    int j, mid, ok;
+
+    if (hi - lo < ECDSA_BATCH_MIN) {
+        ecdsa_batch_each(b, lo, hi, results);
+        return;
+    }
+    if (!bad && (ok = ecdsa_batch_check(b, lo, hi)) != 0) {
+        if (ok < 0)
+            ecdsa_batch_each(b, lo, hi, results);
+        else
+            for (j = lo; j < hi; j++)
+                results[b->idx[j]] = 0;
+        return;
+    }
+    mid = lo + (hi - lo) / 2;
+    if ((ok = ecdsa_batch_check(b, lo, mid)) > 0) {
+        for (j = lo; j < mid; j++)
+            results[b->idx[j]] = 0;
+        ecdsa_batch_bisect(b, mid, hi, 1, results);
+    }
+    else if (ok == 0 && (ok = ecdsa_batch_check(b, mid, hi)) > 0) {
+        for (j = mid; j < hi; j++)
+            results[b->idx[j]] = 0;
+        ecdsa_batch_bisect(b, lo, mid, 1, results);
+    }
+    else
+        ecdsa_batch_each(b, lo, hi, results);
+}
+
+/*
+ * ecdsa_ctx_verify_batch() - count개의 서명 (msgs[i], lens[i], Qs[i], rs[i], ss[i])을 한꺼번에 검증한다.
+ * 각 서명의 결과는 ecdsa_p256_verify()와 같은 값으로 results[i]에 넣으며, 모두 올바르면 0,
+ * 하나라도 올바르지 않으면 ECDSA_SIG_MISMATCH를 반환한다.
+ * 서명마다 r과 ecdsa_p256_sign_recid()가 준 복원 색인 recids[i]로 R을 복원하고 128비트 난수 a_i를 골라
+ * Σ a_i(u1_i G + u2_i Q_i - R_i) = O를 한 번에 확인한다. G의 계수는 하나로 모아 G_table로 계산하고
+ * 나머지 2*count개 항은 ecc_msm()으로 계산하며, s_i의 역원도 한 번의 역원 계산으로 구한다.
+ * 식에는 R 자체가 들어가므로 r만으로는 두 후보 ±R 중 어느 것인지 알 수 없다. 짐작으로 묶으면 절반쯤이
+ * 틀려 묶음이 거의 늘 실패하므로, recids가 NULL이거나 recids[i]가 음수인 서명은 묶지 않고
+ * ecdsa_p256_verify()로 하나씩 검증한다. 따라서 복원 색인이 없으면 개별 검증을 반복하는 것과 같다.
+ * 틀린 복원 색인이나 올바르지 않은 서명은 ecdsa_batch_bisect()가 찾아 하나씩 검증하고, Q가 O이거나
+ * 곡선 위에 없거나 r로 R을 복원할 수 없는 서명은 처음부터 하나씩 검증하므로 결과는 항상 개별 검증과 같다.
+ * 작업 공간을 할당하지 못하면 모든 서명을 하나씩 검증한다.
+ */
+// 서명 count개를 ecdsa_p256_verify()로 하나씩 검증한다. 반환 값은 ecdsa_ctx_verify_batch()와 같다
+static int ecdsa_verify_each(ecdsa_ctx_t *ctx, const void *msgs[], const size_t lens[], const ecdsa_p256_t Qs[], const void *rs[], const void *ss[], int count, int results[], int sha2_ndx)
+{
+    int i, ret = 0;
+
+    for (i = 0; i < count; i++)
+        if ((results[i] = ecdsa_ctx_verify(ctx, msgs[i], lens[i], &Qs[i], rs[i], ss[i], sha2_ndx)) != 0)
+            ret = ECDSA_SIG_MISMATCH;
+    return ret;
+}
+
+int ecdsa_ctx_verify_batch(ecdsa_ctx_t *ctx, const void *msgs[], const size_t lens[], const ecdsa_p256_t Qs[], const void *rs[], const void *ss[], const int recids[], int count, int results[], int sha2_ndx)
+{
+    unsigned char x1[ECDSA_P256/8];
+    ecdsa_batch_t b;
+    p256_sc *e, *w, a, u;
+    p256_fe y;
+    ecc_point_t Q;
+    int i, j, m, recid;
+
+    if (count <= 0)
+        return 0;
+    if (recids == NULL)
+        return ecdsa_verify_each(ctx, msgs, lens, Qs, rs, ss, count, results, sha2_ndx);
+    b.ctx = ctx;
+    b.msgs = msgs;
+    b.lens = lens;
+    b.Qs = Qs;
+    b.rs = rs;
+    b.ss = ss;
+    b.sha2_ndx = sha2_ndx;
+    b.idx = malloc(count * sizeof(int));
+    b.g = malloc(count * sizeof(p256_sc));
+    b.k = malloc(2 * count * sizeof(p256_sc));
+    b.P = malloc(2 * count * sizeof(ecc_affine_t));
+    e = malloc(count * sizeof(p256_sc));
+    w = malloc(count * sizeof(p256_sc));
+    if (b.idx == NULL || b.g == NULL || b.k == NULL || b.P == NULL || e == NULL || w == NULL) {
+        free(b.idx);
+        free(b.g);
+        free(b.k);
+        free(b.P);
+        free(e);
+        free(w);
+        return ecdsa_verify_each(ctx, msgs, lens, Qs, rs, ss, count, results, sha2_ndx);
+    }
+
+    // 범위를 벗어난 서명은 바로 오류 코드를 정하고, 묶음에 넣을 수 없는 서명은 따로 검증한다
+    for (i = 0, m = 0; i < count; i++) {
+        if (lens[i] > 0x1fffffffffffffff) {
+            results[i] = ECDSA_MSG_TOO_LONG;
+            continue;
+        }
+        if (!p256_sc_from_bytes(b.k[2*m], rs[i]) || !p256_sc_from_bytes(w[m], ss[i]) || p256_sc_is_zero(b.k[2*m]) || p256_sc_is_zero(w[m])) {
+            results[i] = ECDSA_SIG_INVALID;
+            continue;
+        }
+        ecc_point_import(&Q, &Qs[i]);
+        p256_fe_from_bytes(b.P[2*m+1].x, rs[i]);
+        recid = recids[i] & 3;
+        // x1 = r + n이 p 이상이면 더한 값이 n보다 작아지므로 그런 R은 없다
+        if (recid & 2) {
+            p256_fe_add(b.P[2*m+1].x, b.P[2*m+1].x, ECC_ORDER);
+            p256_fe_to_bytes(x1, b.P[2*m+1].x);
+        }
+        if (recids[i] < 0 || p256_fe_is_zero(Q.Z) || !ecc_on_curve(Q.X, Q.Y) || ((recid & 2) && p256_sc_from_bytes(u, x1)) || !ecc_lift_x(y, b.P[2*m+1].x)) {
+            results[i] = ecdsa_ctx_verify(ctx, msgs[i], lens[i], &Qs[i], rs[i], ss[i], sha2_ndx);
+            continue;
+        }
+        if (!(recid & 1))
+            p256_fe_neg(y, y);
+        p256_fe_copy(b.P[2*m+1].y, y);      // -R
+        p256_fe_copy(b.P[2*m].x, Q.X);
+        p256_fe_copy(b.P[2*m].y, Q.Y);
+        ecdsa_hash(e[m], msgs[i], lens[i], sha2_ndx);
+        b.idx[m++] = i;
+    }
+
+    // w = s^-1, u1 = ew, u2 = rw를 구하고 난수 a를 곱한다
+    ecc_sc_inv_batch(w, m);
+    for (j = 0; j < m; j++) {
+        memset(a, 0, sizeof(p256_sc));
+        arc4random_buf(a, 16);
+        a[0] |= 1;
+        p256_sc_mul(u, e[j], w[j]);
+        p256_sc_mul(b.g[j], a, u);          // a*u1
+        p256_sc_mul(u, b.k[2*j], w[j]);
+        p256_sc_mul(b.k[2*j], a, u);        // a*u2
+        memcpy(b.k[2*j+1], a, sizeof(p256_sc));
+    }
+    if (m > 0)
+        ecdsa_batch_bisect(&b, 0, m, 0, results);
+
+    free(b.idx);
+    free(b.g);
+    free(b.k);
+    free(b.P);
+    free(e);
+    free(w);
+    for (i = 0; i < count; i++)
+        if (results[i] != 0)
+            return ECDSA_SIG_MISMATCH;
+    return 0;
+}
+
+/*
+ * ECDH는 Co-Z 몬트고메리 사다리로 dQ의 x좌표만 계산한다(Rivain, "Fast and regular algorithms for
+ * scalar multiplication over elliptic curves", 2011). 사다리의 두 점 R0, R1은 항상 같은 Z를 공유하므로
+ * Z를 따로 들고 있지 않으며, 비트마다 XYCZ-ADDC와 XYCZ-ADD를 한 번씩 같은 순서로 수행하고
+ * 비트 값은 두 점을 분기 없이 맞바꾸는 데에만 쓴다. 역원은 마지막에 x를 구할 때 한 번만 계산한다.
+ */
+// flag가 1이면 a와 b를 맞바꾼다. 분기 없이 수행한다
+static void ecc_fe_cswap(p256_fe a, p256_fe b, int flag)
+{
+    p256_fe t;
+
+    p256_fe_copy(t, a);
+    p256_fe_cmov(a, b, flag);
+    p256_fe_cmov(b, t, flag);
+}
+
+/*
+ * ecc_zaddu() - XYCZ-ADD. Z를 공유하는 P1, P2로 P2 <- P1 + P2를 계산하고 P1은 새 Z에 맞게 바꾼다.
+ * 새 Z는 Z * (X2 - X1)이다. 4M + 2S
+ */
+static void ecc_zaddu(p256_fe X1, p256_fe Y1, p256_fe X2, p256_fe Y2)
+{
+    p256_fe a, b, c, d, e;
+
+    p256_fe_sub(a, X2, X1);
+    p256_fe_sqr(a, a);                      // A = (X2 - X1)^2
+    p256_fe_mul(b, X1, a);                  // B = X1 * A
+    p256_fe_mul(c, X2, a);                  // C = X2 * A
+    p256_fe_sub(d, Y2, Y1);                 // Y2 - Y1
+    p256_fe_sqr(X2, d);
+    p256_fe_sub(X2, X2, b);
+    p256_fe_sub(X2, X2, c);                 // X3 = (Y2 - Y1)^2 - B - C
+    p256_fe_sub(e, c, b);
+    p256_fe_mul(Y1, Y1, e);                 // E = Y1 * (C - B)
+    p256_fe_sub(e, b, X2);
+    p256_fe_mul(Y2, d, e);
+    p256_fe_sub(Y2, Y2, Y1);                // Y3 = (Y2 - Y1)(B - X3) - E
+    p256_fe_copy(X1, b);
+}
+
+/*
+ * ecc_zaddc() - XYCZ-ADDC. Z를 공유하는 P1, P2로 (P1 - P2, P1 + P2)를 계산해 각각 P1, P2에 넣는다.
+ * 두 결과도 Z * (X2 - X1)을 공유한다. 5M + 3S
+ */
+static void ecc_zaddc(p256_fe X1, p256_fe Y1, p256_fe X2, p256_fe Y2)
+{
+    p256_fe a, b, c, d, e, f;
+
+    p256_fe_sub(a, X2, X1);
+    p256_fe_sqr(a, a);                      // A = (X2 - X1)^2
+    p256_fe_mul(b, X1, a);                  // B = X1 * A
+    p256_fe_mul(c, X2, a);                  // C = X2 * A
+    p256_fe_sub(d, Y2, Y1);                 // Y2 - Y1
+    p256_fe_add(f, Y2, Y1);                 // Y2 + Y1
+    p256_fe_sub(e, c, b);
+    p256_fe_mul(e, Y1, e);                  // E = Y1 * (C - B)
+    // P1 + P2
+    p256_fe_sqr(X2, d);
+    p256_fe_sub(X2, X2, b);
+    p256_fe_sub(X2, X2, c);                 // X3 = (Y2 - Y1)^2 - B - C
+    p256_fe_sub(a, b, X2);
+    p256_fe_mul(Y2, d, a);
+    p256_fe_sub(Y2, Y2, e);                 // Y3 = (Y2 - Y1)(B - X3) - E
+    // P1 - P2
+    p256_fe_sqr(X1, f);
+    p256_fe_sub(X1, X1, b);
+    p256_fe_sub(X1, X1, c);                 // X3' = (Y1 + Y2)^2 - B - C
+    p256_fe_sub(a, X1, b);
+    p256_fe_mul(Y1, f, a);
+    p256_fe_sub(Y1, Y1, e);                 // Y3' = (Y1 + Y2)(X3' - B) - E
+}
+
+/*
+ * ecc_ladder_scalar() - 사다리의 길이가 d와 무관하도록 k = d + n 또는 d + 2n 중 257번째 비트가
+ * 1인 것을 분기 없이 고른다. k ≡ d (mod n)이므로 kQ = dQ이다.
+ */
+static void ecc_ladder_scalar(uint64_t k[5], const p256_sc d)
+{
+    unsigned __int128 t;
+    uint64_t a[5], b[5], mask;
+    int i;
+
+    for (i = 0, t = 0; i < 4; i++) {
+        t += (unsigned __int128)d[i] + ECC_ORDER[i];
+        a[i] = (uint64_t)t;
+        t >>= 64;
+    }
+    a[4] = (uint64_t)t;
+    for (i = 0, t = 0; i < 4; i++) {
+        t += (unsigned __int128)a[i] + ECC_ORDER[i];
+        b[i] = (uint64_t)t;
+        t >>= 64;
+    }
+    b[4] = a[4] + (uint64_t)t;
+    mask = -(a[4] & 1);
+    for (i = 0; i < 5; i++)
+        k[i] = b[i] ^ (mask & (a[i] ^ b[i]));
+}
+
+/*
+ * ecc_mul_ladder() - 아핀 좌표의 점 P = (xP, yP)에 대해 dP의 x좌표를 x에 넣는다.
+ * 사다리는 R1 - R0 = P를 유지하며 k의 비트 b마다 (R_1-b, R_b) <- XYCZ-ADDC(R_b, R_1-b),
+ * (R_b, R_1-b) <- XYCZ-ADD(R_1-b, R_b)를 수행한다. 마지막 비트의 ADDC 뒤에는 R_b = ±P이므로
+ * X_b = xP * Z^2에서 Z를 알 수 있고, 이것으로 역원 한 번에 x = X0 / Z'^2을 구한다.
+ * 따라서 xP = 0이면 Z를 구할 수 없다. b는 p에 대한 이차잉여이므로 (0, ±√b)는 곡선 위의 점이고
+ * 상대가 고를 수 있는 공개키이다. 이때와 결과가 무한원점이거나 중간에 무한원점이 나오는
+ * d(1, n-2, n-1)에서는 0을 반환한다.
+ */
+static int ecc_mul_ladder(p256_fe x, const p256_sc d, const p256_fe xP, const p256_fe yP)
+{
+    p256_fe X0, Y0, X1, Y1, m, s, t;
+    uint64_t k[5];
+    int i, b, swap = 0;
+
+    ecc_ladder_scalar(k, d);
+
+    // XYCZ-IDBL: Z = 2yP로 R1 = 2P, R0 = P를 만든다
+    p256_fe_sqr(m, xP);
+    p256_fe_add(t, m, m);
+    p256_fe_add(m, m, t);
+    p256_fe_add(t, ONE, ONE);
+    p256_fe_add(t, t, ONE);
+    p256_fe_sub(m, m, t);                   // M = 3xP^2 - 3
+    p256_fe_sqr(t, yP);
+    p256_fe_add(t, t, t);                   // 2yP^2
+    p256_fe_mul(s, xP, t);
+    p256_fe_add(s, s, s);                   // S = 4xP*yP^2
+    p256_fe_sqr(Y0, t);
+    p256_fe_add(Y0, Y0, Y0);                // 8yP^4
+    p256_fe_copy(X0, s);
+    p256_fe_sqr(X1, m);
+    p256_fe_sub(X1, X1, s);
+    p256_fe_sub(X1, X1, s);                 // X(2P) = M^2 - 2S
+    p256_fe_sub(t, s, X1);
+    p256_fe_mul(Y1, m, t);
+    p256_fe_sub(Y1, Y1, Y0);                // Y(2P) = M(S - X) - 8yP^4
+
+    // R0을 R_b, R1을 R_1-b로 두도록 비트가 바뀔 때만 맞바꾼다
+    for (i = ECDSA_P256 - 1; i >= 0; i--) {
+        b = (int)((k[i/64] >> (i%64)) & 1);
+        ecc_fe_cswap(X0, X1, b ^ swap);
+        ecc_fe_cswap(Y0, Y1, b ^ swap);
+        swap = b;
+        ecc_zaddc(X0, Y0, X1, Y1);          // (R_b, R_1-b) = (R_b - R_1-b, R_b + R_1-b)
+        if (i == 0)
+            break;
+        ecc_zaddu(X1, Y1, X0, Y0);          // R_b = R_1-b + R_b
+    }
+
+    // R_b = ±P이므로 Z^2 = X_b / xP이고, 마지막 ADD 뒤의 Z'은 Z * (X_b - X_1-b)이다
+    p256_fe_sub(t, X0, X1);
+    p256_fe_sqr(t, t);
+    p256_fe_mul(t, t, X0);                  // X_b * (X_b - X_1-b)^2 = xP * Z'^2
+    ecc_zaddu(X1, Y1, X0, Y0);
+    ecc_fe_cswap(X0, X1, swap);
+    ecc_fe_cswap(Y0, Y1, swap);             // R0 = kP
+    p256_fe_inv(t, t);
+    p256_fe_mul(t, t, xP);                  // Z'^-2
+    p256_fe_mul(x, X0, t);
+    memset(k, 0, sizeof(k));
+    return !p256_fe_is_zero(t);
+}
+
+/*
+ * ecc_mul_complete() - 아핀 좌표의 점 P = (xP, yP)에 대해 dP의 x좌표를 x에 넣는다.
+ * 완전 공식으로 비트마다 두배와 덧셈을 모두 하고 덧셈 결과를 비트에 따라 분기 없이 고르므로,
+ * 사다리가 다루지 못하는 입력에서도 연산 순서가 d와 무관하다. 사다리보다 세 배쯤 느리므로 예외에만 쓴다.
+ */
+static void ecc_mul_complete(p256_fe x, const p256_sc d, const p256_fe xP, const p256_fe yP)
+{
+    ecc_affine_t A;
+    ecc_proj_t S, U;
+    ecc_point_t R;
+    int i, b;
+
+    p256_fe_copy(A.x, xP);
+    p256_fe_copy(A.y, yP);
+    p256_fe_set_ui(S.X, 0);
+    p256_fe_set_ui(S.Y, 1);
+    p256_fe_set_ui(S.Z, 0);
+    for (i = ECDSA_P256 - 1; i >= 0; i--) {
+        ecc_proj_doubling(&S);
+        U = S;
+        ecc_add_complete(&U, &A);
+        b = (int)((d[i/64] >> (i%64)) & 1);
+        p256_fe_cmov(S.X, U.X, b);
+        p256_fe_cmov(S.Y, U.Y, b);
+        p256_fe_cmov(S.Z, U.Z, b);
+    }
+    ecc_proj_to_jacobian(&R, &S);
+    ecc_normalize(&R);
+    p256_fe_copy(x, R.X);
+    memset(&S, 0, sizeof(S));
+    memset(&U, 0, sizeof(U));
+}
+
+/*
+ * ecdh_p256(d, Q, z) - 개인키 d와 상대의 공개키 Q로 공유 비밀 z = x(dQ)를 32바이트로 계산한다.
+ * Q는 곡선 위의 점이어야 하며 그렇지 않으면 ECDSA_POINT_INVALID를, d가 [1, n-1]에 있지 않으면
+ * ECDSA_SIG_INVALID를 반환한다. 성공하면 0을 반환한다.
+ */
+int ecdh_p256(const void *d, const ecdsa_p256_t *Q, void *z)
+{
+    p256_fe x, y, zx;
+    p256_sc k;
+
+    if (!p256_fe_from_bytes(x, Q->x) || !p256_fe_from_bytes(y, Q->y) || !ecc_on_curve(x, y))
+        return ECDSA_POINT_INVALID;
+    if (!p256_sc_from_bytes(k, d) || p256_sc_is_zero(k))
+        return ECDSA_SIG_INVALID;
+    // 사다리의 예외는 완전 공식으로 계산한다. x = 0은 공개된 Q로 정해지고, d = 1, n-2, n-1은
+    // 공개키가 G, -2G, -G이므로 이미 드러나 있다. 따라서 어느 분기도 숨겨야 할 d의 정보를 알려 주지 않는다
+    if (p256_fe_is_zero(x) || !ecc_mul_ladder(zx, k, x, y))
+        ecc_mul_complete(zx, k, x, y);
+    p256_fe_to_bytes(z, zx);
+    memset(k, 0, sizeof(k));
+    return 0;
+}
+
+/*
+ * ecdsa_p256_compress() - 공개키 Q를 SEC1의 압축 형식 (0x02 + y의 홀짝) || x, 33바이트로 out에 쓴다.
+ * Q의 좌표가 p보다 작고 곡선 위에 있어야 하며, 그렇지 않으면 ECDSA_POINT_INVALID를 반환한다.
+ */
+int ecdsa_p256_compress(unsigned char *out, const ecdsa_p256_t *Q)
+{
+    p256_fe x, y;
+
+    if (!p256_fe_from_bytes(x, Q->x) || !p256_fe_from_bytes(y, Q->y) || !ecc_on_curve(x, y))
+        return ECDSA_POINT_INVALID;
+    out[0] = 0x02 | (y[0] & 1);
+    memcpy(out + 1, Q->x, ECDSA_P256/8);
+    return 0;
+}
+
+/*
+ * ecdsa_p256_decompress() - SEC1 압축 형식의 33바이트 in을 공개키 Q로 푼다.
+ * y = sqrt(x^3 - 3x + b)는 p256_fe_sqrt()의 고정된 덧셈 사슬로 구하며, 제곱근이 없으면
+ * x가 곡선 위의 점이 아니다. 앞 바이트가 0x02나 0x03이 아니거나 x가 p 이상이거나 곡선 위의 점이
+ * 아니면 ECDSA_POINT_INVALID를 반환한다.
+ */
+int ecdsa_p256_decompress(ecdsa_p256_t *Q, const unsigned char *in)
+{
+    p256_fe x, y;
+
+    if ((in[0] != 0x02 && in[0] != 0x03) || !p256_fe_from_bytes(x, in + 1) || !ecc_lift_x(y, x))
+        return ECDSA_POINT_INVALID;
+    if ((y[0] & 1) != (in[0] & 1))
+        p256_fe_neg(y, y);
+    memcpy(Q->x, in + 1, ECDSA_P256/8);
+    p256_fe_to_bytes(Q->y, y);
+    return 0;
+}
+
+/*
+ * ecdsa_ctx_recover(ctx, msg, len, r, s, recid, Q) - 서명 (r, s)와 복원 색인 recid로부터
+ * 메시지 m에 서명한 공개키 Q를 복원한다. x1 = r (recid의 비트 1이 켜져 있으면 r + n)을
+ * p256_fe_sqrt()로 곡선 위의 점 R로 올리고, y의 홀짝은 recid의 비트 0으로 고른 뒤
+ * Q = r^-1(sR - eG) = (-e r^-1)G + (s r^-1)R을 ecc_mul_joint()로 한 번에 계산한다.
+ * 복원된 Q로는 (r, s)가 항상 검증을 통과하므로, 서명을 검증하려면 Q가 믿을 수 있는 키인지만 확인하면 된다.
+ * r이나 s가 범위를 벗어나거나 R이나 Q를 만들 수 없으면 ECDSA_SIG_INVALID를 반환한다. 성공하면 0을 반환한다.
+ */
+int ecdsa_ctx_recover(ecdsa_ctx_t *ctx, const void *msg, size_t len, const void *_r, const void *_s, int recid, ecdsa_p256_t *_Q, int sha2_ndx)
+{
+    unsigned char x1[ECDSA_P256/8];
+    p256_sc r, s, e, w, u1, u2;
+    ecc_point_t R, Q;
+
+    if (len > 0x1fffffffffffffff)
+        return ECDSA_MSG_TOO_LONG;
+    if (recid < 0 || recid > 3)
+        return ECDSA_SIG_INVALID;
+    if (!p256_sc_from_bytes(r, _r) || !p256_sc_from_bytes(s, _s) || p256_sc_is_zero(r) || p256_sc_is_zero(s))
+        return ECDSA_SIG_INVALID;
+
+    // x1 = r 또는 r + n. r + n >= p이면 더한 값이 다시 n보다 작아지므로 그런 x1은 없다
+    p256_fe_from_bytes(R.X, _r);
+    if (recid & 2) {
+        p256_fe_add(R.X, R.X, ECC_ORDER);
+        p256_fe_to_bytes(x1, R.X);
+        if (p256_sc_from_bytes(w, x1))
+            return ECDSA_SIG_INVALID;
+    }
+    if (!ecc_lift_x(R.Y, R.X))
+        return ECDSA_SIG_INVALID;
+    if (recid & 1)
+        p256_fe_neg(R.Y, R.Y);
+    p256_fe_set_ui(R.Z, 1);
+
+    // u1 = -e r^-1, u2 = s r^-1
+    ecdsa_hash(e, msg, len, sha2_ndx);
+    p256_sc_inv(w, r);
+    p256_sc_mul(u1, e, w);
+    p256_sc_neg(u1, u1);
+    p256_sc_mul(u2, s, w);
+
+    ecc_mul_joint(ctx, &Q, u1, &R, u2);
+    ecc_normalize(&Q);
+    if (p256_fe_is_zero(Q.Z))
+        return ECDSA_SIG_INVALID;
+    ecc_point_export(_Q, &Q);
+    return 0;
+}
+
+/*
+ * 서명 풀. 서명 비용의 대부분인 kG, r = x1 mod n, k^-1은 메시지와 무관하므로 배경 스레드가
+ * 미리 (k^-1, r) 쌍을 만들어 고리 버퍼에 채워 둔다. 온라인 서명은 해시와 스칼라 곱셈 두 번만 한다.
+ * 고리 버퍼는 칸마다 순번을 두는 잠금 없는 다중 생산자/다중 소비자 큐이므로 여러 스레드가 동시에
+ * ecdsa_pool_sign()을 불러도 된다. 버퍼가 가득 차면 배경 스레드는 잠들고, 소비자가 쌍을 꺼내면 깨어난다.
+ * 풀에서 쓰는 k는 RFC 6979가 아니라 arc4random_buf()로 뽑으므로 풀로 만든 서명은 결정적이지 않다.
+ */
+typedef struct {
+    atomic_size_t seq;
+    p256_sc kinv, r;
+} ecdsa_pool_slot_t;
+
+struct ecdsa_pool {
+    ecdsa_ctx_t *ctx;
+    ecdsa_pool_slot_t *slot;
+    size_t mask;
+    atomic_size_t head, tail;       // 다음에 꺼낼 위치, 다음에 넣을 위치
+    atomic_int stop, sleeping;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+};
+
+/*
+ * ecdsa_presign() - 메시지와 무관한 서명의 앞부분을 계산한다. kinv = k^-1, r = x1 mod n이다.
+ * 문맥의 표만 읽으므로 여러 스레드가 한 문맥으로 동시에 불러도 된다.
+ */
+static void ecdsa_presign(const ecdsa_ctx_t *ctx, p256_sc kinv, p256_sc r)
+{
+    unsigned char x1[ECDSA_P256/8];
+    p256_sc k;
+    ecc_point_t R;
+
+    do {
+        ecdsa_random_k(k);
+        ecc_mul_base(ctx, &R, k);
+        ecc_normalize(&R);
+        p256_fe_to_bytes(x1, R.X);
+        p256_sc_from_bytes(r, x1);
+    } while (p256_sc_is_zero(r));
+    p256_sc_inv(kinv, k);
+    memset(k, 0, sizeof(p256_sc));
+}
+
+// 고리 버퍼에 (kinv, r)을 넣는다. 가득 차 있으면 0을 반환한다
+static int ecdsa_pool_push(ecdsa_pool_t *pool, const p256_sc kinv, const p256_sc r)
+{
+    ecdsa_pool_slot_t *slot;
+    size_t pos = atomic_load_explicit(&pool->tail, memory_order_relaxed), seq;
+    long dif;
+
+    for (;;) {
+        slot = &pool->slot[pos & pool->mask];
+        seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        dif = (long)seq - (long)pos;
+        if (dif == 0) {
+            if (atomic_compare_exchange_weak_explicit(&pool->tail, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed))
+                break;
+        }
+        else if (dif < 0)
+            return 0;
+        else
+            pos = atomic_load_explicit(&pool->tail, memory_order_relaxed);
+    }
+    memcpy(slot->kinv, kinv, sizeof(p256_sc));
+    memcpy(slot->r, r, sizeof(p256_sc));
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+    return 1;
+}
+
+// 고리 버퍼에서 (kinv, r)을 꺼낸다. 비어 있으면 0을 반환한다
+static int ecdsa_pool_pop(ecdsa_pool_t *pool, p256_sc kinv, p256_sc r)
+{
+    ecdsa_pool_slot_t *slot;
+    size_t pos = atomic_load_explicit(&pool->head, memory_order_relaxed), seq;
+    long dif;
+
+    for (;;) {
+        slot = &pool->slot[pos & pool->mask];
+        seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        dif = (long)seq - (long)(pos + 1);
+        if (dif == 0) {
+            if (atomic_compare_exchange_weak_explicit(&pool->head, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed))
+                break;
+        }
+        else if (dif < 0)
+            return 0;
+        else
+            pos = atomic_load_explicit(&pool->head, memory_order_relaxed);
+    }
+    memcpy(kinv, slot->kinv, sizeof(p256_sc));
+    memcpy(r, slot->r, sizeof(p256_sc));
+    memset(slot->kinv, 0, sizeof(p256_sc));
+    atomic_store_explicit(&slot->seq, pos + pool->mask + 1, memory_order_release);
+    return 1;
+}
+
+// 배경 스레드. 버퍼를 채우다가 가득 차면 꺼내는 쪽이 깨울 때까지(길어도 100ms) 잠든다
+static void *ecdsa_pool_main(void *arg)
+{
+    ecdsa_pool_t *pool = arg;
+    p256_sc kinv, r;
+    struct timespec ts;
+    int have = 0;
+
+    while (!atomic_load(&pool->stop)) {
+        if (!have) {
+            ecdsa_presign(pool->ctx, kinv, r);
+            have = 1;
+        }
+        if (ecdsa_pool_push(pool, kinv, r)) {
+            have = 0;
+            continue;
+        }
+        pthread_mutex_lock(&pool->lock);
+        atomic_store(&pool->sleeping, 1);
+        if (!atomic_load(&pool->stop)) {
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_nsec += 100000000;
+            if (ts.tv_nsec >= 1000000000) {
+                ts.tv_sec++;
+                ts.tv_nsec -= 1000000000;
+            }
+            pthread_cond_timedwait(&pool->cond, &pool->lock, &ts);
+        }
+        atomic_store(&pool->sleeping, 0);
+        pthread_mutex_unlock(&pool->lock);
+    }
+    memset(kinv, 0, sizeof(p256_sc));
+    return NULL;
+}
+
+/*
+ * ecdsa_pool_new() - (k^-1, r) 쌍을 최대 size개(2의 거듭제곱으로 올림) 보관하는 서명 풀을 만들고
+ * 배경 스레드를 시작한다. 풀은 자기 문맥을 가지므로 다른 문맥과 상태를 공유하지 않는다.
+ * 실패하면 NULL을 반환한다.
+ */
+ecdsa_pool_t *ecdsa_pool_new(int size)
+{
+    ecdsa_pool_t *pool;
+    size_t i, cap = 1;
+
+    while (cap < (size_t)(size > 1 ? size : 1))
+        cap <<= 1;
+    if ((pool = malloc(sizeof(ecdsa_pool_t))) == NULL)
+        return NULL;
+    if ((pool->slot = malloc(cap * sizeof(ecdsa_pool_slot_t))) == NULL || (pool->ctx = ecdsa_ctx_new()) == NULL) {
+        free(pool->slot);
+        free(pool);
+        return NULL;
+    }
+    for (i = 0; i < cap; i++)
+        atomic_init(&pool->slot[i].seq, i);
+    pool->mask = cap - 1;
+    atomic_init(&pool->head, 0);
+    atomic_init(&pool->tail, 0);
+    atomic_init(&pool->stop, 0);
+    atomic_init(&pool->sleeping, 0);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->cond, NULL);
+    if (pthread_create(&pool->thread, NULL, ecdsa_pool_main, pool) != 0) {
+        pthread_mutex_destroy(&pool->lock);
+        pthread_cond_destroy(&pool->cond);
+        ecdsa_ctx_free(pool->ctx);
+        free(pool->slot);
+        free(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+/*
+ * ecdsa_pool_free() - 배경 스레드를 멈추고 남은 쌍을 지운 뒤 풀을 반납한다.
+ */
+void ecdsa_pool_free(ecdsa_pool_t *pool)
+{
+    if (pool == NULL)
+        return;
+    pthread_mutex_lock(&pool->lock);
+    atomic_store(&pool->stop, 1);
+    pthread_cond_signal(&pool->cond);
+    pthread_mutex_unlock(&pool->lock);
+    pthread_join(pool->thread, NULL);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->cond);
+    memset(pool->slot, 0, (pool->mask + 1) * sizeof(ecdsa_pool_slot_t));
+    ecdsa_ctx_free(pool->ctx);
+    free(pool->slot);
+    free(pool);
+}
+
+/*
+ * ecdsa_pool_sign(pool, msg, len, d, r, s) - 풀에 미리 만든 (k^-1, r)로 서명한다.
+ * 온라인으로는 e = H(m)과 s = k^-1 * (e + rd) mod n만 계산한다. 풀이 비어 있으면 그 자리에서
+ * 쌍을 만들므로 기다리지 않는다. 인자와 반환 값은 ecdsa_p256_sign()과 같다.
+ */
+int ecdsa_pool_sign(ecdsa_pool_t *pool, const void *msg, size_t len, const void *d, void *_r, void *_s, int sha2_ndx)
+{
+    p256_sc e, temp_d, kinv, r, s;
+
+    ecdsa_hash(e, msg, len, sha2_ndx);
+    p256_sc_from_bytes(temp_d, d);
+    do {
+        if (ecdsa_pool_pop(pool, kinv, r)) {
+            if (atomic_load(&pool->sleeping)) {
+                pthread_mutex_lock(&pool->lock);
+                pthread_cond_signal(&pool->cond);
+                pthread_mutex_unlock(&pool->lock);
+            }
+        }
+        else
+            ecdsa_presign(pool->ctx, kinv, r);
+        p256_sc_mul(s, r, temp_d);      // s = r*d
+        p256_sc_add(s, e, s);           // s = e + r*d
+        p256_sc_mul(s, kinv, s);        // s = k^-1 * (e + rd) mod n
+    } while (p256_sc_is_zero(s));
+
+    p256_sc_to_bytes(_r, r);
+    p256_sc_to_bytes(_s, s);
+    memset(kinv, 0, sizeof(p256_sc));
+    memset(temp_d, 0, sizeof(p256_sc));
+    return 0;
+}
+
+/*
+ * 곡선 기술자. P-256, P-384, P-521, secp256k1의 유한체와 스칼라 연산을 같은 모양의 함수 포인터로
+ * 묶고 곡선 상수 a, b와 G를 림 형태로 담는다. 림 수는 곡선마다 p256.c, p384.c, p521.c, k256.c에서
+ * 컴파일 시간에 고정되어 있고 축약도 곡선마다 따로 특수화되어 있으므로, 아래의 일반 구현은 점 연산과
+ * ECDSA의 순서만 맡는다. 좌표는 가장 큰 곡선에 맞춘 ECC_LIMBS_MAX개의 림에 담고 앞쪽 림만 쓴다.
+ * sc_split이 있는 곡선은 자기 준동형 사상 (x, y) -> (beta*x, y)로 GLV 곱셈을 한다.
+ */
+#define ECC_LIMBS_MAX P521_LIMBS
+#define ECC_BYTES_MAX ECDSA_BYTES(ECDSA_P521)
+#define ECC_WINDOWS_MAX (ECDSA_P521/4 + 2)
+
+typedef uint64_t ecc_limbs_t[ECC_LIMBS_MAX];
+
+struct ecdsa_curve {
+    int bits, size;                 // n의 비트 수와 좌표, 스칼라의 바이트 수
+    int a;                          // 곡선 계수 a로 -3 또는 0이다
+    ecc_limbs_t b, gx, gy;
+    int (*fe_from_bytes)(uint64_t *r, const unsigned char *in);
+    void (*fe_to_bytes)(unsigned char *out, const uint64_t *a);
+    void (*fe_set_ui)(uint64_t *r, uint64_t a);
+    void (*fe_cmov)(uint64_t *r, const uint64_t *a, int flag);
+    int (*fe_is_zero)(const uint64_t *a);
+    int (*fe_equal)(const uint64_t *a, const uint64_t *b);
+    void (*fe_add)(uint64_t *r, const uint64_t *a, const uint64_t *b);
+    void (*fe_sub)(uint64_t *r, const uint64_t *a, const uint64_t *b);
+    void (*fe_neg)(uint64_t *r, const uint64_t *a);
+    void (*fe_mul)(uint64_t *r, const uint64_t *a, const uint64_t *b);
+    void (*fe_sqr)(uint64_t *r, const uint64_t *a);
+    void (*fe_inv)(uint64_t *r, const uint64_t *a);
+    int (*sc_from_bytes)(uint64_t *r, const unsigned char *in);
+    void (*sc_to_bytes)(unsigned char *out, const uint64_t *a);
+    int (*sc_is_zero)(const uint64_t *a);
+    int (*sc_equal)(const uint64_t *a, const uint64_t *b);
+    void (*sc_add)(uint64_t *r, const uint64_t *a, const uint64_t *b);
+    void (*sc_neg)(uint64_t *r, const uint64_t *a);
+    void (*sc_mul)(uint64_t *r, const uint64_t *a, const uint64_t *b);
+    void (*sc_inv)(uint64_t *r, const uint64_t *a);
+    void (*sc_split)(uint64_t *k1, uint64_t *k2, int *neg1, int *neg2, const uint64_t *k);
+    ecc_limbs_t beta;               // sc_split이 없는 곡선은 NULL과 0으로 둔다
+};
+
+#define ECDSA_CURVE_OPS(pfx) \
+    pfx##_fe_from_bytes, pfx##_fe_to_bytes, pfx##_fe_set_ui, pfx##_fe_cmov, pfx##_fe_is_zero, pfx##_fe_equal, \
+    pfx##_fe_add, pfx##_fe_sub, pfx##_fe_neg, pfx##_fe_mul, pfx##_fe_sqr, pfx##_fe_inv, \
+    pfx##_sc_from_bytes, pfx##_sc_to_bytes, pfx##_sc_is_zero, pfx##_sc_equal, \
+    pfx##_sc_add, pfx##_sc_neg, pfx##_sc_mul, pfx##_sc_inv
+
+const ecdsa_curve_t ecdsa_curve_p256 = {
+    ECDSA_P256, ECDSA_BYTES(ECDSA_P256), -3,
+    {0x3bce3c3e27d2604bULL, 0x651d06b0cc53b0f6ULL, 0xb3ebbd55769886bcULL, 0x5ac635d8aa3a93e7ULL},
+    {0xf4a13945d898c296ULL, 0x77037d812deb33a0ULL, 0xf8bce6e563a440f2ULL, 0x6b17d1f2e12c4247ULL},
+    {0xcbb6406837bf51f5ULL, 0x2bce33576b315eceULL, 0x8ee7eb4a7c0f9e16ULL, 0x4fe342e2fe1a7f9bULL},
+    ECDSA_CURVE_OPS(p256),
+    NULL,
+    {0}
+};
+
+const ecdsa_curve_t ecdsa_curve_p384 = {
+    ECDSA_P384, ECDSA_BYTES(ECDSA_P384), -3,
+    {0x2a85c8edd3ec2aefULL, 0xc656398d8a2ed19dULL, 0x0314088f5013875aULL,
+     0x181d9c6efe814112ULL, 0x988e056be3f82d19ULL, 0xb3312fa7e23ee7e4ULL},
+    {0x3a545e3872760ab7ULL, 0x5502f25dbf55296cULL, 0x59f741e082542a38ULL,
+     0x6e1d3b628ba79b98ULL, 0x8eb1c71ef320ad74ULL, 0xaa87ca22be8b0537ULL},
+    {0x7a431d7c90ea0e5fULL, 0x0a60b1ce1d7e819dULL, 0xe9da3113b5f0b8c0ULL,
+     0xf8f41dbd289a147cULL, 0x5d9e98bf9292dc29ULL, 0x3617de4a96262c6fULL},
+    ECDSA_CURVE_OPS(p384),
+    NULL,
+    {0}
+};
+
+const ecdsa_curve_t ecdsa_curve_p521 = {
+    ECDSA_P521, ECDSA_BYTES(ECDSA_P521), -3,
+    {0xef451fd46b503f00ULL, 0x3573df883d2c34f1ULL, 0x1652c0bd3bb1bf07ULL,
+     0x56193951ec7e937bULL, 0xb8b489918ef109e1ULL, 0xa2da725b99b315f3ULL,
+     0x929a21a0b68540eeULL, 0x953eb9618e1c9a1fULL, 0x0000000000000051ULL},
+    {0xf97e7e31c2e5bd66ULL, 0x3348b3c1856a429bULL, 0xfe1dc127a2ffa8deULL,
+     0xa14b5e77efe75928ULL, 0xf828af606b4d3dbaULL, 0x9c648139053fb521ULL,
+     0x9e3ecb662395b442ULL, 0x858e06b70404e9cdULL, 0x00000000000000c6ULL},
+    {0x88be94769fd16650ULL, 0x353c7086a272c240ULL, 0xc550b9013fad0761ULL,
+     0x97ee72995ef42640ULL, 0x17afbd17273e662cULL, 0x98f54449579b4468ULL,
+     0x5c8a5fb42c7d1bd9ULL, 0x39296a789a3bc004ULL, 0x0000000000000118ULL},
+    ECDSA_CURVE_OPS(p521),
+    NULL,
+    {0}
+};
+
+const ecdsa_curve_t ecdsa_curve_secp256k1 = {
+    ECDSA_P256, ECDSA_BYTES(ECDSA_P256), 0,
+    {7, 0, 0, 0},
+    {0x59f2815b16f81798ULL, 0x029bfcdb2dce28d9ULL, 0x55a06295ce870b07ULL, 0x79be667ef9dcbbacULL},
+    {0x9c47d08ffb10d4b8ULL, 0xfd17b448a6855419ULL, 0x5da4fbfc0e1108a8ULL, 0x483ada7726a3c465ULL},
+    ECDSA_CURVE_OPS(k256),
+    k256_sc_split,
+    {0xc1396c28719501eeULL, 0x9cf0497512f58995ULL, 0x6e64479eac3434e9ULL, 0x7ae96a2b657c0710ULL}
+};
+
+// 곡선 기술자로 계산하는 자코비안 좌표의 점이다. Z = 0이면 무한원점 O이다
+typedef struct {
+    ecc_limbs_t X, Y, Z;
+} curve_point_t;
+
+/*
+ * P = O = (1, 1, 0)으로 둔다. P-521의 최상위 림은 9비트만 쓰므로 Z만 0으로 두고 X, Y에 남은 값을
+ * 두배 연산에 넣으면 축약의 입력 범위를 벗어날 수 있다.
+ */
+static void curve_infinity(const ecdsa_curve_t *C, curve_point_t *P)
+{
+    C->fe_set_ui(P->X, 1);
+    C->fe_set_ui(P->Y, 1);
+    C->fe_set_ui(P->Z, 0);
+}
+
+// 자코비안 좌표에서 a = 0인 곡선의 P = 2P를 계산한다 (dbl-2009-l)
+static void curve_doubling_a0(const ecdsa_curve_t *C, curve_point_t *P)
+{
+    ecc_limbs_t a, b, c, d, e;
+
+    C->fe_sqr(a, P->X);
+    C->fe_sqr(b, P->Y);
+    C->fe_sqr(c, b);
+    C->fe_add(d, P->X, b);
+    C->fe_sqr(d, d);
+    C->fe_sub(d, d, a);
+    C->fe_sub(d, d, c);
+    C->fe_add(d, d, d);                 // D = 2((X + B)^2 - A - C)
+    C->fe_add(e, a, a);
+    C->fe_add(e, e, a);                 // E = 3A
+
+    C->fe_mul(P->Z, P->Y, P->Z);
+    C->fe_add(P->Z, P->Z, P->Z);        // Z3 = 2YZ
+    C->fe_sqr(P->X, e);
+    C->fe_sub(P->X, P->X, d);
+    C->fe_sub(P->X, P->X, d);           // X3 = E^2 - 2D
+    C->fe_sub(d, d, P->X);
+    C->fe_mul(P->Y, e, d);
+    C->fe_add(c, c, c);
+    C->fe_add(c, c, c);
+    C->fe_add(c, c, c);
+    C->fe_sub(P->Y, P->Y, c);           // Y3 = E(D - X3) - 8C
+}
+
+// 자코비안 좌표에서 P = 2P를 계산한다. a = -3이면 ecc_doubling()과 같은 공식이다
+static void curve_doubling(const ecdsa_curve_t *C, curve_point_t *P)
+{
+    ecc_limbs_t delta, gamma, beta, alpha, t;
+
+    if (C->a == 0) {
+        curve_doubling_a0(C, P);
+        return;
+    }
+    C->fe_sqr(delta, P->Z);
+    C->fe_sqr(gamma, P->Y);
+    C->fe_mul(beta, P->X, gamma);
+    C->fe_sub(alpha, P->X, delta);
+    C->fe_add(t, P->X, delta);
+    C->fe_mul(alpha, alpha, t);
+    C->fe_add(t, alpha, alpha);
+    C->fe_add(alpha, alpha, t);         // alpha = 3(X - delta)(X + delta)
+
+    C->fe_add(P->Z, P->Y, P->Z);
+    C->fe_sqr(P->Z, P->Z);
+    C->fe_sub(P->Z, P->Z, gamma);
+    C->fe_sub(P->Z, P->Z, delta);       // Z3 = (Y + Z)^2 - gamma - delta
+    C->fe_add(beta, beta, beta);
+    C->fe_add(beta, beta, beta);
+    C->fe_sqr(P->X, alpha);
+    C->fe_sub(P->X, P->X, beta);
+    C->fe_sub(P->X, P->X, beta);        // X3 = alpha^2 - 8beta
+    C->fe_sub(beta, beta, P->X);
+    C->fe_mul(P->Y, alpha, beta);
+    C->fe_sqr(gamma, gamma);
+    C->fe_add(gamma, gamma, gamma);
+    C->fe_add(gamma, gamma, gamma);
+    C->fe_add(gamma, gamma, gamma);
+    C->fe_sub(P->Y, P->Y, gamma);       // Y3 = alpha(4beta - X3) - 8gamma^2
+}
+
+// 자코비안 좌표에서 P = P + Q를 계산한다. ecc_add()와 같이 O, P = Q, P = -Q를 처리한다
+static void curve_add(const ecdsa_curve_t *C, curve_point_t *P, const curve_point_t *Q)
+{
+    ecc_limbs_t z1z1, z2z2, u1, s1, h, r, i, j;
+
+    if (C->fe_is_zero(Q->Z))
+        return;
+    if (C->fe_is_zero(P->Z)) {
+        *P = *Q;
+        return;
+    }
+    C->fe_sqr(z1z1, P->Z);
+    C->fe_sqr(z2z2, Q->Z);
+    C->fe_mul(u1, P->X, z2z2);              // U1 = X1*Z2^2
+    C->fe_mul(s1, Q->Z, z2z2);
+    C->fe_mul(s1, P->Y, s1);                // S1 = Y1*Z2^3
+    C->fe_mul(h, Q->X, z1z1);
+    C->fe_sub(h, h, u1);                    // H = X2*Z1^2 - U1
+    C->fe_mul(r, P->Z, z1z1);
+    C->fe_mul(r, Q->Y, r);
+    C->fe_sub(r, r, s1);
+    C->fe_add(r, r, r);                     // r = 2(Y2*Z1^3 - S1)
+
+    if (C->fe_is_zero(h)) {
+        if (C->fe_is_zero(r))
+            curve_doubling(C, P);
+        else
+            C->fe_set_ui(P->Z, 0);
+        return;
+    }
+
+    C->fe_mul(P->Z, P->Z, Q->Z);
+    C->fe_mul(P->Z, P->Z, h);
+    C->fe_add(P->Z, P->Z, P->Z);            // Z3 = 2*Z1*Z2*H
+    C->fe_add(i, h, h);
+    C->fe_sqr(i, i);
+    C->fe_mul(j, h, i);
+    C->fe_mul(u1, u1, i);                   // I = (2H)^2, J = H*I, V = U1*I
+    C->fe_sqr(P->X, r);
+    C->fe_sub(P->X, P->X, j);
+    C->fe_sub(P->X, P->X, u1);
+    C->fe_sub(P->X, P->X, u1);              // X3 = r^2 - J - 2V
+    C->fe_sub(u1, u1, P->X);
+    C->fe_mul(P->Y, r, u1);
+    C->fe_mul(s1, s1, j);
+    C->fe_add(s1, s1, s1);
+    C->fe_sub(P->Y, P->Y, s1);              // Y3 = r(V - X3) - 2*S1*J
+}
+
+// 자코비안 좌표를 아핀 좌표로 바꾼다
+static void curve_normalize(const ecdsa_curve_t *C, curve_point_t *P)
+{
+    ecc_limbs_t zinv, t;
+
+    if (C->fe_is_zero(P->Z))
+        return;
+    C->fe_inv(zinv, P->Z);
+    C->fe_sqr(t, zinv);
+    C->fe_mul(P->X, P->X, t);
+    C->fe_mul(t, t, zinv);
+    C->fe_mul(P->Y, P->Y, t);
+    C->fe_set_ui(P->Z, 1);
+}
+
+// 아핀 좌표의 (x, y)가 곡선 y^2 = x^3 + ax + b 위에 있으면 1을 반환한다
+static int curve_on_curve(const ecdsa_curve_t *C, const uint64_t *x, const uint64_t *y)
+{
+    ecc_limbs_t t, u;
+
+    C->fe_sqr(t, x);
+    C->fe_mul(t, t, x);
+    if (C->a == -3) {
+        C->fe_add(u, x, x);
+        C->fe_add(u, u, x);
+        C->fe_sub(t, t, u);
+    }
+    C->fe_add(t, t, C->b);
+    C->fe_sqr(u, y);
+    return C->fe_equal(t, u);
+}
+
+// bits비트인 k를 부호 있는 4비트 자리수 d_i ∈ [-8, 7]로 바꾼다. ecc_recode_signed4()의 일반형으로 자리수 개수를 반환한다
+static int curve_recode_signed4(signed char d[ECC_WINDOWS_MAX], const uint64_t *k, int bits)
+{
+    int i, w, carry = 0, cnt = (bits + 3) / 4 + 1;
+
+    for (i = 0; i < cnt - 1; i++) {
+        w = (int)((k[i/16] >> (4 * (i%16))) & 0xf) + carry;
+        carry = (w + 8) >> 4;
+        d[i] = (signed char)(w - (carry << 4));
+    }
+    d[cnt - 1] = (signed char)carry;
+    return cnt;
+}
+
+// tbl[j-1] = jP (j = 1..8)를 만든다
+static void curve_multiples(const ecdsa_curve_t *C, curve_point_t tbl[8], const curve_point_t *P)
+{
+    int j;
+
+    tbl[0] = *P;
+    for (j = 1; j < 8; j++) {
+        tbl[j] = tbl[j-1];
+        curve_add(C, &tbl[j], P);
+    }
+}
+
+// 곡선 기술자로 계산하는 동차 사영 좌표 (X : Y : Z)의 점이다. x = X/Z, y = Y/Z이며 O는 (0 : 1 : 0)이다
+typedef struct {
+    ecc_limbs_t X, Y, Z;
+} curve_proj_t;
+
+/*
+ * curve_proj_add() - 동차 사영 좌표에서 P = P + Q를 Renes-Costello-Batina 완전 덧셈 공식으로 계산한다.
+ * a = -3이면 2015/1060의 알고리즘 4, a = 0이면 알고리즘 7이다. 두 곡선 모두 위수가 소수이므로
+ * P = O, Q = O, P = Q, P = -Q를 포함한 모든 입력에 같은 연산 순서로 올바른 값을 낸다.
+ */
+static void curve_proj_add(const ecdsa_curve_t *C, curve_proj_t *P, const curve_proj_t *Q)
+{
+    ecc_limbs_t t0, t1, t2, t3, t4, X3, Y3, Z3;
+
+    C->fe_mul(t0, P->X, Q->X);
+    C->fe_mul(t1, P->Y, Q->Y);
+    C->fe_mul(t2, P->Z, Q->Z);
+    C->fe_add(t3, P->X, P->Y);
+    C->fe_add(t4, Q->X, Q->Y);
+    C->fe_mul(t3, t3, t4);
+    C->fe_add(t4, t0, t1);
+    C->fe_sub(t3, t3, t4);              // t3 = X1*Y2 + X2*Y1
+    C->fe_add(t4, P->Y, P->Z);
+    C->fe_add(X3, Q->Y, Q->Z);
+    C->fe_mul(t4, t4, X3);
+    C->fe_add(X3, t1, t2);
+    C->fe_sub(t4, t4, X3);              // t4 = Y1*Z2 + Y2*Z1
+    C->fe_add(X3, P->X, P->Z);
+    C->fe_add(Y3, Q->X, Q->Z);
+    C->fe_mul(X3, X3, Y3);
+    C->fe_add(Y3, t0, t2);
+    C->fe_sub(Y3, X3, Y3);              // Y3 = X1*Z2 + X2*Z1
+    if (C->a == 0) {
+        C->fe_add(X3, t0, t0);
+        C->fe_add(t0, X3, t0);          // t0 = 3*X1*X2
+        C->fe_add(Z3, C->b, C->b);
+        C->fe_add(Z3, Z3, C->b);        // b3 = 3b
+        C->fe_mul(t2, Z3, t2);
+        C->fe_mul(Y3, Z3, Y3);
+        C->fe_add(Z3, t1, t2);
+        C->fe_sub(t1, t1, t2);
+        C->fe_mul(X3, t4, Y3);
+        C->fe_mul(t2, t3, t1);
+        C->fe_sub(P->X, t2, X3);
+        C->fe_mul(Y3, Y3, t0);
+        C->fe_mul(t1, t1, Z3);
+        C->fe_add(P->Y, t1, Y3);
+        C->fe_mul(t0, t0, t3);
+        C->fe_mul(Z3, Z3, t4);
+        C->fe_add(P->Z, Z3, t0);
+        return;
+    }
+    C->fe_mul(Z3, C->b, t2);
+    C->fe_sub(X3, Y3, Z3);
+    C->fe_add(Z3, X3, X3);
+    C->fe_add(X3, X3, Z3);
+    C->fe_sub(Z3, t1, X3);
+    C->fe_add(X3, t1, X3);
+    C->fe_mul(Y3, C->b, Y3);
+    C->fe_add(t1, t2, t2);
+    C->fe_add(t2, t1, t2);              // t2 = 3*Z1*Z2
+    C->fe_sub(Y3, Y3, t2);
+    C->fe_sub(Y3, Y3, t0);
+    C->fe_add(t1, Y3, Y3);
+    C->fe_add(Y3, t1, Y3);
+    C->fe_add(t1, t0, t0);
+    C->fe_add(t0, t1, t0);
+    C->fe_sub(t0, t0, t2);
+    C->fe_mul(t1, t4, Y3);
+    C->fe_mul(t2, t0, Y3);
+    C->fe_mul(Y3, X3, Z3);
+    C->fe_add(P->Y, Y3, t2);
+    C->fe_mul(X3, X3, t3);
+    C->fe_sub(P->X, X3, t1);
+    C->fe_mul(Z3, t4, Z3);
+    C->fe_mul(t1, t3, t0);
+    C->fe_add(P->Z, Z3, t1);
+}
+
+/*
+ * curve_proj_doubling() - 동차 사영 좌표에서 P = 2P를 완전 두배 공식으로 계산한다.
+ * a = -3이면 2015/1060의 알고리즘 6, a = 0이면 알고리즘 9이며 P = O에도 분기 없이 O를 낸다.
+ */
+static void curve_proj_doubling(const ecdsa_curve_t *C, curve_proj_t *P)
+{
+    ecc_limbs_t t0, t1, t2, t3, X3, Y3, Z3;
+
+    if (C->a == 0) {
+        C->fe_sqr(t0, P->Y);
+        C->fe_add(Z3, t0, t0);
+        C->fe_add(Z3, Z3, Z3);
+        C->fe_add(Z3, Z3, Z3);          // Z3 = 8Y^2
+        C->fe_mul(t1, P->Y, P->Z);
+        C->fe_sqr(t2, P->Z);
+        C->fe_add(t3, C->b, C->b);
+        C->fe_add(t3, t3, C->b);
+        C->fe_mul(t2, t3, t2);          // t2 = 3b*Z^2
+        C->fe_mul(X3, t2, Z3);
+        C->fe_add(Y3, t0, t2);
+        C->fe_mul(Z3, t1, Z3);
+        C->fe_add(t1, t2, t2);
+        C->fe_add(t2, t1, t2);
+        C->fe_sub(t0, t0, t2);
+        C->fe_mul(Y3, t0, Y3);
+        C->fe_add(Y3, X3, Y3);
+        C->fe_mul(t1, P->X, P->Y);
+        C->fe_mul(X3, t0, t1);
+        C->fe_add(P->X, X3, X3);
+        memcpy(P->Y, Y3, sizeof(ecc_limbs_t));
+        memcpy(P->Z, Z3, sizeof(ecc_limbs_t));
+        return;
+    }
+    C->fe_sqr(t0, P->X);
+    C->fe_sqr(t1, P->Y);
+    C->fe_sqr(t2, P->Z);
+    C->fe_mul(t3, P->X, P->Y);
+    C->fe_add(t3, t3, t3);
+    C->fe_mul(Z3, P->X, P->Z);
+    C->fe_add(Z3, Z3, Z3);
+    C->fe_mul(Y3, C->b, t2);
+    C->fe_sub(Y3, Y3, Z3);
+    C->fe_add(X3, Y3, Y3);
+    C->fe_add(Y3, X3, Y3);
+    C->fe_sub(X3, t1, Y3);
+    C->fe_add(Y3, t1, Y3);
+    C->fe_mul(Y3, X3, Y3);
+    C->fe_mul(X3, X3, t3);
+    C->fe_add(t3, t2, t2);
+    C->fe_add(t2, t2, t3);
+    C->fe_mul(Z3, C->b, Z3);
+    C->fe_sub(Z3, Z3, t2);
+    C->fe_sub(Z3, Z3, t0);
+    C->fe_add(t3, Z3, Z3);
+    C->fe_add(Z3, Z3, t3);
+    C->fe_add(t3, t0, t0);
+    C->fe_add(t0, t3, t0);
+    C->fe_sub(t0, t0, t2);
+    C->fe_mul(t0, t0, Z3);
+    C->fe_add(Y3, Y3, t0);
+    C->fe_mul(t0, P->Y, P->Z);
+    C->fe_add(t0, t0, t0);
+    C->fe_mul(Z3, t0, Z3);
+    C->fe_sub(P->X, X3, Z3);
+    C->fe_mul(Z3, t0, t1);
+    C->fe_add(Z3, Z3, Z3);
+    C->fe_add(P->Z, Z3, Z3);
+    memcpy(P->Y, Y3, sizeof(ecc_limbs_t));
+}
+
+// 자코비안 좌표 (X, Y, Z)를 동차 사영 좌표 (XZ : Y : Z^3)으로 바꾼다
+static void curve_proj_from_jacobian(const ecdsa_curve_t *C, curve_proj_t *R, const curve_point_t *P)
+{
+    ecc_limbs_t t;
+
+    C->fe_mul(R->X, P->X, P->Z);
+    memcpy(R->Y, P->Y, sizeof(ecc_limbs_t));
+    C->fe_sqr(t, P->Z);
+    C->fe_mul(R->Z, t, P->Z);
+}
+
+// 동차 사영 좌표 (X : Y : Z)를 자코비안 좌표 (XZ, YZ^2, Z)로 바꾼다. O = (0 : 1 : 0)은 Z = 0인 점이 된다
+static void curve_proj_to_jacobian(const ecdsa_curve_t *C, curve_point_t *R, const curve_proj_t *P)
+{
+    ecc_limbs_t t;
+
+    C->fe_mul(R->X, P->X, P->Z);
+    C->fe_sqr(t, P->Z);
+    C->fe_mul(R->Y, P->Y, t);
+    memcpy(R->Z, P->Z, sizeof(ecc_limbs_t));
+}
+
+// 표 전체를 읽어 dP (d ∈ [-8, 8])를 분기 없이 고른다. d = 0이면 완전 덧셈 공식에 그대로 넣을 수 있는 O = (0 : 1 : 0)이 된다
+static void curve_proj_select(const ecdsa_curve_t *C, curve_proj_t *T, const curve_proj_t tbl[8], int d)
+{
+    int j, neg = d < 0, abs = neg ? -d : d;
+    ecc_limbs_t negy;
+
+    C->fe_set_ui(T->X, 0);
+    C->fe_set_ui(T->Y, 1);
+    C->fe_set_ui(T->Z, 0);
+    for (j = 0; j < 8; j++) {
+        C->fe_cmov(T->X, tbl[j].X, j + 1 == abs);
+        C->fe_cmov(T->Y, tbl[j].Y, j + 1 == abs);
+        C->fe_cmov(T->Z, tbl[j].Z, j + 1 == abs);
+    }
+    C->fe_neg(negy, T->Y);
+    C->fe_cmov(T->Y, negy, neg);
+}
+
+/*
+ * curve_endo_tables() - tbl1[j-1] = ±jP, tbl2[j-1] = ±lambda*jP (j = 1..8)를 만든다. lambda*(X, Y, Z)는
+ * (beta*X, Y, Z)이므로 두 번째 표는 곱셈 여덟 번으로 얻는다. 부호는 neg1, neg2에 따라 분기 없이 바꾼다.
+ */
+static void curve_endo_tables(const ecdsa_curve_t *C, curve_point_t tbl1[8], curve_point_t tbl2[8], const curve_point_t *P, int neg1, int neg2)
+{
+    ecc_limbs_t negy;
+    int j;
+
+    curve_multiples(C, tbl1, P);
+    for (j = 0; j < 8; j++) {
+        tbl2[j] = tbl1[j];
+        C->fe_mul(tbl2[j].X, tbl1[j].X, C->beta);
+        C->fe_neg(negy, tbl1[j].Y);
+        C->fe_cmov(tbl1[j].Y, negy, neg1);
+        C->fe_cmov(tbl2[j].Y, negy, neg2);
+    }
+}
+
+/*
+ * curve_mul_base_glv() - k = k1 + k2*lambda로 나누어 R = k1*G + k2*(lambda*G)를 계산한다.
+ * k1, k2가 128비트이므로 윈도우가 33개로 줄어 두배 연산이 절반이 되며, 윈도우마다 두 표에서
+ * 분기 없이 고른 점을 하나씩 더한다. curve_mul_base()와 같이 완전 공식을 쓰고 자리수가 0이면 O를 더하므로
+ * 연산 순서가 k와 무관하다.
+ */
+static void curve_mul_base_glv(const ecdsa_curve_t *C, curve_point_t *R, const uint64_t *k)
+{
+    signed char d1[ECC_WINDOWS_MAX], d2[ECC_WINDOWS_MAX];
+    curve_point_t G, jtbl1[8], jtbl2[8];
+    curve_proj_t tbl1[8], tbl2[8], S, T;
+    ecc_limbs_t k1, k2;
+    int i, cnt, neg1, neg2;
+
+    C->sc_split(k1, k2, &neg1, &neg2, k);
+    memcpy(G.X, C->gx, sizeof(ecc_limbs_t));
+    memcpy(G.Y, C->gy, sizeof(ecc_limbs_t));
+    C->fe_set_ui(G.Z, 1);
+    curve_endo_tables(C, jtbl1, jtbl2, &G, neg1, neg2);
+    for (i = 0; i < 8; i++) {
+        curve_proj_from_jacobian(C, &tbl1[i], &jtbl1[i]);
+        curve_proj_from_jacobian(C, &tbl2[i], &jtbl2[i]);
+    }
+    cnt = curve_recode_signed4(d1, k1, 128);
+    curve_recode_signed4(d2, k2, 128);
+    C->fe_set_ui(S.X, 0);
+    C->fe_set_ui(S.Y, 1);
+    C->fe_set_ui(S.Z, 0);
+    for (i = cnt - 1; i >= 0; i--) {
+        curve_proj_doubling(C, &S);
+        curve_proj_doubling(C, &S);
+        curve_proj_doubling(C, &S);
+        curve_proj_doubling(C, &S);
+        curve_proj_select(C, &T, tbl1, d1[i]);
+        curve_proj_add(C, &S, &T);
+        curve_proj_select(C, &T, tbl2, d2[i]);
+        curve_proj_add(C, &S, &T);
+    }
+    curve_proj_to_jacobian(C, R, &S);
+    memset(k1, 0, sizeof(k1));
+    memset(k2, 0, sizeof(k2));
+    memset(d1, 0, sizeof(d1));
+    memset(d2, 0, sizeof(d2));
+}
+
+/*
+ * curve_mul_base() - R = kG를 고정된 4비트 윈도우로 계산한다. 윈도우마다 완전 두배 공식 네 번과
+ * 표에서 분기 없이 고른 점의 완전 덧셈 한 번을 한다. 자리수가 0이면 O를 더하고, 누적값이 O이거나
+ * 더하는 점과 같아도 같은 공식을 쓰므로 연산 순서가 k와 무관하다.
+ */
+static void curve_mul_base(const ecdsa_curve_t *C, curve_point_t *R, const uint64_t *k)
+{
+    signed char d[ECC_WINDOWS_MAX];
+    curve_point_t G, jtbl[8];
+    curve_proj_t tbl[8], S, T;
+    int i, cnt;
+
+    if (C->sc_split) {
+        curve_mul_base_glv(C, R, k);
+        return;
+    }
+    memcpy(G.X, C->gx, sizeof(ecc_limbs_t));
+    memcpy(G.Y, C->gy, sizeof(ecc_limbs_t));
+    C->fe_set_ui(G.Z, 1);
+    curve_multiples(C, jtbl, &G);
+    for (i = 0; i < 8; i++)
+        curve_proj_from_jacobian(C, &tbl[i], &jtbl[i]);
+    cnt = curve_recode_signed4(d, k, C->bits);
+    C->fe_set_ui(S.X, 0);
+    C->fe_set_ui(S.Y, 1);
+    C->fe_set_ui(S.Z, 0);
+    for (i = cnt - 1; i >= 0; i--) {
+        curve_proj_doubling(C, &S);
+        curve_proj_doubling(C, &S);
+        curve_proj_doubling(C, &S);
+        curve_proj_doubling(C, &S);
+        curve_proj_select(C, &T, tbl, d[i]);
+        curve_proj_add(C, &S, &T);
+    }
+    curve_proj_to_jacobian(C, R, &S);
+    memset(d, 0, sizeof(d));
+}
+
+// R = R + dP를 표에서 바로 조회해 더한다. d = 0이면 아무것도 하지 않는다 (검증용)
+static void curve_add_digit(const ecdsa_curve_t *C, curve_point_t *R, const curve_point_t tbl[8], int d)
+{
+    curve_point_t T;
+
+    if (d == 0)
+        return;
+    T = tbl[(d > 0 ? d : -d) - 1];
+    if (d < 0)
+        C->fe_neg(T.Y, T.Y);
+    curve_add(C, R, &T);
+}
+
+/*
+ * curve_mul_joint_glv() - u1, u2를 각각 128비트 두 개로 나누어 R = a1*G + a2*(lambda*G) + b1*Q + b2*(lambda*Q)를
+ * 네 스칼라의 자리수를 엇갈려 더하는 방식으로 계산한다. 두배 연산은 132번이다.
+ */
+static void curve_mul_joint_glv(const ecdsa_curve_t *C, curve_point_t *R, const uint64_t *u1, const curve_point_t *Q, const uint64_t *u2)
+{
+    signed char a1[ECC_WINDOWS_MAX], a2[ECC_WINDOWS_MAX], b1[ECC_WINDOWS_MAX], b2[ECC_WINDOWS_MAX];
+    curve_point_t G, tblG[8], tblGL[8], tblQ[8], tblQL[8];
+    ecc_limbs_t k1, k2;
+    int i, cnt, neg1, neg2;
+
+    memcpy(G.X, C->gx, sizeof(ecc_limbs_t));
+    memcpy(G.Y, C->gy, sizeof(ecc_limbs_t));
+    C->fe_set_ui(G.Z, 1);
+    C->sc_split(k1, k2, &neg1, &neg2, u1);
+    curve_endo_tables(C, tblG, tblGL, &G, neg1, neg2);
+    cnt = curve_recode_signed4(a1, k1, 128);
+    curve_recode_signed4(a2, k2, 128);
+    C->sc_split(k1, k2, &neg1, &neg2, u2);
+    curve_endo_tables(C, tblQ, tblQL, Q, neg1, neg2);
+    curve_recode_signed4(b1, k1, 128);
+    curve_recode_signed4(b2, k2, 128);
+    curve_infinity(C, R);
+    for (i = cnt - 1; i >= 0; i--) {
+        curve_doubling(C, R);
+        curve_doubling(C, R);
+        curve_doubling(C, R);
+        curve_doubling(C, R);
+        curve_add_digit(C, R, tblG, a1[i]);
+        curve_add_digit(C, R, tblGL, a2[i]);
+        curve_add_digit(C, R, tblQ, b1[i]);
+        curve_add_digit(C, R, tblQL, b2[i]);
+    }
+}
+
+/*
+ * curve_mul_joint() - R = u1*G + u2*Q를 두 스칼라의 4비트 자리수를 엇갈려 더하는 방식으로 계산한다.
+ * 검증에서만 쓰므로 자리수로 표를 바로 조회하고 0인 자리수는 건너뛴다.
+ */
+static void curve_mul_joint(const ecdsa_curve_t *C, curve_point_t *R, const uint64_t *u1, const curve_point_t *Q, const uint64_t *u2)
+{
+    signed char d1[ECC_WINDOWS_MAX], d2[ECC_WINDOWS_MAX];
+    curve_point_t G, tblG[8], tblQ[8];
+    int i, cnt;
+
+    if (C->sc_split) {
+        curve_mul_joint_glv(C, R, u1, Q, u2);
+        return;
+    }
+    memcpy(G.X, C->gx, sizeof(ecc_limbs_t));
+    memcpy(G.Y, C->gy, sizeof(ecc_limbs_t));
+    C->fe_set_ui(G.Z, 1);
+    curve_multiples(C, tblG, &G);
+    curve_multiples(C, tblQ, Q);
+    cnt = curve_recode_signed4(d1, u1, C->bits);
+    curve_recode_signed4(d2, u2, C->bits);
+    curve_infinity(C, R);
+    for (i = cnt - 1; i >= 0; i--) {
+        curve_doubling(C, R);
+        curve_doubling(C, R);
+        curve_doubling(C, R);
+        curve_doubling(C, R);
+        curve_add_digit(C, R, tblG, d1[i]);
+        curve_add_digit(C, R, tblQ, d2[i]);
+    }
+}
+
+// e = bits2int(H(m)) mod n. H(m)이 n보다 길면 앞의 bits비트만 쓴다
+static void curve_hash(const ecdsa_curve_t *C, uint64_t *e, const void *msg, size_t len, int sha2_ndx)
+{
+    unsigned char digest[SHA512_DIGEST_SIZE], buf[ECC_BYTES_MAX];
+
+    sha(msg, len, digest, sha2_ndx);
+    ecdsa_bits2int(buf, C->size, C->bits, digest, SHA2SIZE(sha2_ndx));
+    C->sc_from_bytes(e, buf);
+}
+
+/*
+ * curve_rfc6979() - RFC 6979 3.2로 k를 만든다. rfc6979_init(), rfc6979_next()와 같은 절차를
+ * 곡선의 길이 qlen = bits, rlen = size로 일반화한 것으로, 개인키별 중간 상태는 저장하지 않는다.
+ * retry번째로 만든 k를 돌려준다.
+ */
+static void curve_rfc6979(const ecdsa_curve_t *C, uint64_t *k, const unsigned char *x, const unsigned char *h1, int sha2_ndx, int retry)
+{
+    unsigned char V[SHA512_DIGEST_SIZE], K[SHA512_DIGEST_SIZE], T[ECC_BYTES_MAX + SHA512_DIGEST_SIZE], buf[ECC_BYTES_MAX], b;
+    int hlen = SHA2SIZE(sha2_ndx), tlen, round;
+    hmac_key_t H;
+    sha2_ctx_t c;
+
+    // b, c. V = 0x01...01, K = 0x00...00
+    memset(V, 0x01, hlen);
+    memset(K, 0x00, hlen);
+    // d ~ g. K = HMAC_K(V || b || x || h1), V = HMAC_K(V)를 b = 0x00, 0x01로 두 번 한다
+    for (b = 0x00; b <= 0x01; b++) {
+        hmac_setkey(&H, sha2_ndx, K, hlen);
+        c = H.in;
+        sha2_update(&c, V, hlen);
+        sha2_update(&c, &b, 1);
+        sha2_update(&c, x, C->size);
+        sha2_update(&c, h1, C->size);
+        hmac_finish(&H, &c, K);
+        hmac_setkey(&H, sha2_ndx, K, hlen);
+        c = H.in;
+        sha2_update(&c, V, hlen);
+        hmac_finish(&H, &c, V);
+    }
+    // h. T를 rlen 바이트 이상 채운 뒤 k = bits2int(T)가 [1, n-1]에 있으면 쓴다
+    for (round = 0;; round++) {
+        if (round > 0) {
+            b = 0x00;
+            c = H.in;
+            sha2_update(&c, V, hlen);
+            sha2_update(&c, &b, 1);
+            hmac_finish(&H, &c, K);
+            hmac_setkey(&H, sha2_ndx, K, hlen);
+            c = H.in;
+            sha2_update(&c, V, hlen);
+            hmac_finish(&H, &c, V);
+        }
+        for (tlen = 0; tlen < C->size; tlen += hlen) {
+            c = H.in;
+            sha2_update(&c, V, hlen);
+            hmac_finish(&H, &c, V);
+            memcpy(T + tlen, V, hlen);
+        }
+        ecdsa_bits2int(buf, C->size, C->bits, T, tlen);
+        if (C->sc_from_bytes(k, buf) && !C->sc_is_zero(k) && retry-- == 0)
+            break;
+    }
+    memset(K, 0, sizeof(K));
+    memset(T, 0, sizeof(T));
+    memset(&H, 0, sizeof(H));
+}
+
+/*
+ * ecdsa_curve_bits(), ecdsa_curve_size() - 곡선의 비트 크기와, 좌표와 스칼라 하나의 바이트 크기를 돌려준다.
+ */
+int ecdsa_curve_bits(const ecdsa_curve_t *curve)
+{
+    return curve->bits;
+}
+
+int ecdsa_curve_size(const ecdsa_curve_t *curve)
+{
+    return curve->size;
+}
+
+/*
+ * ecdsa_key(curve, d, Q) - 곡선 curve의 개인키 d ∈ [1, n-1]과 공개키 Q = dG를 무작위로 만든다.
+ * d는 ecdsa_curve_size() 바이트, Q는 x || y로 그 두 배이며 ecdsa_p256_t, ecdsa_p384_t,
+ * ecdsa_p521_t와 같은 배치이다.
+ */
+void ecdsa_key(const ecdsa_curve_t *curve, void *d, void *Q)
+{
+    const ecdsa_curve_t *C = curve;
+    unsigned char buf[ECC_BYTES_MAX], *q = Q;
+    ecc_limbs_t k;
+    curve_point_t R;
+
+    do {
+        arc4random_buf(buf, C->size);
+        if (C->bits % 8)
+            buf[0] &= 0xff >> (8 - C->bits % 8);
+    } while (!C->sc_from_bytes(k, buf) || C->sc_is_zero(k));
+    curve_mul_base(C, &R, k);
+    curve_normalize(C, &R);
+    C->fe_to_bytes(q, R.X);
+    C->fe_to_bytes(q + C->size, R.Y);
+    memcpy(d, buf, C->size);
+    memset(buf, 0, sizeof(buf));
+    memset(k, 0, sizeof(k));
+}
+
+/*
+ * ecdsa_sign(curve, msg, len, d, r, s) - 곡선 curve에서 ecdsa_p256_sign()과 같은 서명을 만든다.
+ * e는 H(m)의 앞쪽 min(hlen, bits)비트이고 k는 RFC 6979로 만들므로 P-256에서는 두 함수의 서명이 같다.
+ * 성공하면 0, 그렇지 않으면 오류 코드를 넘겨준다.
+ */
+int ecdsa_sign(const ecdsa_curve_t *curve, const void *msg, size_t len, const void *d, void *_r, void *_s, int sha2_ndx)
+{
+    const ecdsa_curve_t *C = curve;
+    unsigned char x[ECC_BYTES_MAX], h1[ECC_BYTES_MAX], x1[ECC_BYTES_MAX];
+    ecc_limbs_t e, dd, k, r, s;
+    curve_point_t R;
+    int retry = 0;
+
+    curve_hash(C, e, msg, len, sha2_ndx);
+    C->sc_from_bytes(dd, d);
+    C->sc_to_bytes(x, dd);
+    C->sc_to_bytes(h1, e);
+    do {
+        curve_rfc6979(C, k, x, h1, sha2_ndx, retry++);
+        curve_mul_base(C, &R, k);
+        curve_normalize(C, &R);
+        C->fe_to_bytes(x1, R.X);
+        C->sc_from_bytes(r, x1);                // r = x1 mod n
+        C->sc_inv(k, k);
+        C->sc_mul(s, r, dd);
+        C->sc_add(s, e, s);
+        C->sc_mul(s, k, s);                     // s = k^-1 * (e + rd) mod n
+    } while (C->sc_is_zero(r) || C->sc_is_zero(s));
+
+    C->sc_to_bytes(_r, r);
+    C->sc_to_bytes(_s, s);
+    memset(x, 0, sizeof(x));
+    memset(dd, 0, sizeof(dd));
+    memset(k, 0, sizeof(k));
+    return 0;
+}
+
+/*
+ * ecdsa_verify(curve, msg, len, Q, r, s) - 곡선 curve에서 서명 (r, s)를 공개키 Q로 검증한다.
+ * Q의 좌표가 p보다 작고 곡선 위에 있어야 하며, 그렇지 않으면 ECDSA_POINT_INVALID를 반환한다.
+ * 나머지 반환 값은 ecdsa_p256_verify()와 같다.
+ */
+int ecdsa_verify(const ecdsa_curve_t *curve, const void *msg, size_t len, const void *_Q, const void *_r, const void *_s, int sha2_ndx)
+{
+    const ecdsa_curve_t *C = curve;
+    const unsigned char *q = _Q;
+    unsigned char x1[ECC_BYTES_MAX];
+    ecc_limbs_t r, s, e, w, u1, u2, v;
+    curve_point_t Q, R;
+
+    if (len > 0x1fffffffffffffff)
+        return ECDSA_MSG_TOO_LONG;
+    if (!C->fe_from_bytes(Q.X, q) || !C->fe_from_bytes(Q.Y, q + C->size) || !curve_on_curve(C, Q.X, Q.Y))
+        return ECDSA_POINT_INVALID;
+    C->fe_set_ui(Q.Z, 1);
+    if (!C->sc_from_bytes(r, _r) || !C->sc_from_bytes(s, _s) || C->sc_is_zero(r) || C->sc_is_zero(s))
+        return ECDSA_SIG_INVALID;
+
+    curve_hash(C, e, msg, len, sha2_ndx);
+    C->sc_inv(w, s);
+    C->sc_mul(u1, e, w);
+    C->sc_mul(u2, r, w);
+    curve_mul_joint(C, &R, u1, &Q, u2);
+    curve_normalize(C, &R);
+    if (C->fe_is_zero(R.Z))
+        return ECDSA_SIG_INVALID;
+    C->fe_to_bytes(x1, R.X);
+    C->sc_from_bytes(v, x1);
+    if (!C->sc_equal(v, r))
+        return ECDSA_SIG_MISMATCH;
+    return 0;
+}
+
+/*
+ * 아래 함수들은 ecdsa_p256_init()이 만드는 기본 문맥으로 위의 함수들을 부르는 이전 API이다.
+ * 기본 문맥 하나를 공유하므로 여러 스레드에서 동시에 부르면 안 되며, 그럴 때는 스레드마다 문맥을 만든다.
+ */
+
+/*
+ * Initialize 256 bit ECDSA parameters
+ * 기본 문맥을 만든다. 메모리를 할당하지 못하면 ECDSA_NO_MEMORY를 반환한다.
+ */
+int ecdsa_p256_init(void)
+{
+    if ((ecdsa_default = ecdsa_ctx_new()) == NULL)
+        return ECDSA_NO_MEMORY;
+    return 0;
+}
+
+/*
+ * Clear 256 bit ECDSA parameters
+ * 기본 문맥을 반납한다.
+ */
+void ecdsa_p256_clear(void)
+{
+    ecdsa_ctx_free(ecdsa_default);
+    ecdsa_default = NULL;
+}
+
+void ecdsa_p256_cache_budget(size_t bytes)
+{
+    ecdsa_ctx_cache_budget(ecdsa_default, bytes);
+}
+
+void ecdsa_p256_cache_stats(unsigned long *hits, unsigned long *misses)
+{
+    ecdsa_ctx_cache_stats(ecdsa_default, hits, misses);
+}
+
+/*
+ * ecdsa_stats_get() - 서명과 검증의 호출 횟수와 단계별 누적 시간을 st에 복사한다.
+ * 모든 스레드와 문맥의 합이며, ECDSA_STATS 없이 컴파일되었으면 0으로 채우고 0을 반환한다.
+ */
+int ecdsa_stats_get(ecdsa_stats_t *st)
+{
+    memset(st, 0, sizeof(ecdsa_stats_t));
+#ifdef ECDSA_STATS
+    int i;
+
+    st->sign_calls = atomic_load_explicit(&ecdsa_stat_calls[STAT_SIGN], memory_order_relaxed);
+    st->verify_calls = atomic_load_explicit(&ecdsa_stat_calls[STAT_VERIFY], memory_order_relaxed);
+    for (i = 0; i < ECDSA_STAT_PHASES; i++) {
+        st->sign[i] = atomic_load_explicit(&ecdsa_stat_ticks[STAT_SIGN][i], memory_order_relaxed);
+        st->verify[i] = atomic_load_explicit(&ecdsa_stat_ticks[STAT_VERIFY][i], memory_order_relaxed);
+    }
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+// 누적된 측정값을 모두 0으로 되돌린다
+void ecdsa_stats_reset(void)
+{
+#ifdef ECDSA_STATS
+    int i;
+
+    for (i = 0; i < ECDSA_STAT_PHASES; i++) {
+        atomic_store_explicit(&ecdsa_stat_ticks[STAT_SIGN][i], 0, memory_order_relaxed);
+        atomic_store_explicit(&ecdsa_stat_ticks[STAT_VERIFY][i], 0, memory_order_relaxed);
+    }
+    atomic_store_explicit(&ecdsa_stat_calls[STAT_SIGN], 0, memory_order_relaxed);
+    atomic_store_explicit(&ecdsa_stat_calls[STAT_VERIFY], 0, memory_order_relaxed);
+#endif
+}
+
+void ecdsa_p256_key(void *d, ecdsa_p256_t *Q)
+{
+    ecdsa_ctx_key(ecdsa_default, d, Q);
+}
+
+void ecdsa_p256_key_x4(void *d[4], ecdsa_p256_t Q[4])
+{
+    ecdsa_ctx_key_x4(ecdsa_default, d, Q);
+}
+
+int ecdsa_p256_sign(const void *msg, size_t len, const void *d, void *r, void *s, int sha2_ndx)
+{
+    return ecdsa_ctx_sign(ecdsa_default, msg, len, d, r, s, sha2_ndx);
+}
+
+int ecdsa_p256_sign_recid(const void *msg, size_t len, const void *d, void *r, void *s, int *recid, int sha2_ndx)
+{
+    return ecdsa_ctx_sign_recid(ecdsa_default, msg, len, d, r, s, recid, sha2_ndx);
+}
+
+int ecdsa_p256_sign_batch(const void *msgs[], const size_t lens[], const void *d, void *rs[], void *ss[], int count, int sha2_ndx)
+{
+    return ecdsa_ctx_sign_batch(ecdsa_default, msgs, lens, d, rs, ss, count, sha2_ndx);
+}
+
+int ecdsa_p256_verify(const void *msg, size_t len, const ecdsa_p256_t *Q, const void *r, const void *s, int sha2_ndx)
+{
+    return ecdsa_ctx_verify(ecdsa_default, msg, len, Q, r, s, sha2_ndx);
+}
+
+int ecdsa_p256_verify_batch(const void *msgs[], const size_t lens[], const ecdsa_p256_t Qs[], const void *rs[], const void *ss[], const int recids[], int count, int results[], int sha2_ndx)
+{
+    return ecdsa_ctx_verify_batch(ecdsa_default, msgs, lens, Qs, rs, ss, recids, count, results, sha2_ndx);
+}
+
+int ecdsa_p256_recover(const void *msg, size_t len, const void *r, const void *s, int recid, ecdsa_p256_t *Q, int sha2_ndx)
+{
+    return ecdsa_ctx_recover(ecdsa_default, msg, len, r, s, recid, Q, sha2_ndx);
 }
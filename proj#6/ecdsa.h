@@ -29,6 +29,19 @@
 #define ECDSA_MSG_TOO_LONG  1
 #define ECDSA_SIG_INVALID   2
 #define ECDSA_SIG_MISMATCH  3
+#define ECDSA_POINT_INVALID 4
+#define ECDSA_NO_MEMORY     5
+
+/*
+ * SEC1 압축 형식의 공개키 길이로, 0x02 또는 0x03 한 바이트 뒤에 x좌표가 온다.
+ */
+#define ECDSA_P256_COMPRESSED (ECDSA_P256/8 + 1)
+
+/*
+ * 검증 시 자주 쓰이는 공개키의 사전 계산 표를 보관하는 캐시의 기본 메모리 한도(바이트)이다.
+ * ecdsa_p256_cache_budget()로 바꿀 수 있다.
+ */
+#define ECDSA_CACHE_BUDGET (1 << 20)
 
 /*
  * 타원곡선 P-256 상의 점을 나타내기 위한 구조체이다.
@@ -38,11 +51,121 @@ typedef struct {
     unsigned char y[ECDSA_P256/8];
 } ecdsa_p256_t;
 
-void ecdsa_p256_init(void);
+/*
+ * P-384와 P-521의 비트 크기와 그 곡선 위의 점이다. 좌표와 스칼라는 ECDSA_BYTES(비트 크기) 바이트의
+ * 빅 엔디안으로 주고받으며, P-521은 66바이트이다.
+ */
+#define ECDSA_P384 384
+#define ECDSA_P521 521
+#define ECDSA_BYTES(bits) (((bits) + 7) / 8)
+
+typedef struct {
+    unsigned char x[ECDSA_BYTES(ECDSA_P384)];
+    unsigned char y[ECDSA_BYTES(ECDSA_P384)];
+} ecdsa_p384_t;
+
+typedef struct {
+    unsigned char x[ECDSA_BYTES(ECDSA_P521)];
+    unsigned char y[ECDSA_BYTES(ECDSA_P521)];
+} ecdsa_p521_t;
+
+/*
+ * 곡선 기술자로, 곡선의 크기, 상수, 곡선별로 특수화된 유한체와 스칼라 연산을 담는다.
+ * ecdsa_key(), ecdsa_sign(), ecdsa_verify()는 기술자를 받아 어느 곡선에서나 같은 방식으로 동작하며
+ * 변경 가능한 상태가 없으므로 여러 스레드에서 동시에 불러도 된다. P-256은 ecdsa_p256_*() 함수들이
+ * 쓰는 사전 계산 표와 캐시를 갖춘 경로가 따로 있으며, 같은 입력에 같은 서명을 만든다.
+ * secp256k1(ecdsa_curve_secp256k1)은 키와 서명의 배치가 P-256과 같으므로 ecdsa_p256_t를 쓰며,
+ * 자기 준동형 사상으로 스칼라를 128비트 두 개로 나누어 곱셈의 두배 연산을 절반으로 줄인다.
+ */
+typedef struct ecdsa_curve ecdsa_curve_t;
+
+extern const ecdsa_curve_t ecdsa_curve_p256;
+extern const ecdsa_curve_t ecdsa_curve_p384;
+extern const ecdsa_curve_t ecdsa_curve_p521;
+extern const ecdsa_curve_t ecdsa_curve_secp256k1;
+
+int ecdsa_curve_bits(const ecdsa_curve_t *curve);
+int ecdsa_curve_size(const ecdsa_curve_t *curve);
+void ecdsa_key(const ecdsa_curve_t *curve, void *d, void *Q);
+int ecdsa_sign(const ecdsa_curve_t *curve, const void *msg, size_t len, const void *d, void *r, void *s, int sha2_ndx);
+int ecdsa_verify(const ecdsa_curve_t *curve, const void *msg, size_t len, const void *Q, const void *r, const void *s, int sha2_ndx);
+
+/*
+ * ECDSA 문맥으로 G와 G의 사전 계산 표, 공개키 캐시를 담는다.
+ * 문맥끼리는 변경 가능한 상태를 공유하지 않으므로 스레드마다 문맥을 하나씩 만들면 동시에 쓸 수 있다.
+ * 한 문맥을 여러 스레드가 동시에 써서는 안 된다.
+ */
+typedef struct ecdsa_ctx ecdsa_ctx_t;
+
+ecdsa_ctx_t *ecdsa_ctx_new(void);
+void ecdsa_ctx_free(ecdsa_ctx_t *ctx);
+void ecdsa_ctx_key(ecdsa_ctx_t *ctx, void *d, ecdsa_p256_t *Q);
+void ecdsa_ctx_key_x4(ecdsa_ctx_t *ctx, void *d[4], ecdsa_p256_t Q[4]);
+int ecdsa_ctx_sign(ecdsa_ctx_t *ctx, const void *msg, size_t len, const void *d, void *r, void *s, int sha2_ndx);
+int ecdsa_ctx_sign_recid(ecdsa_ctx_t *ctx, const void *msg, size_t len, const void *d, void *r, void *s, int *recid, int sha2_ndx);
+int ecdsa_ctx_sign_batch(ecdsa_ctx_t *ctx, const void *msgs[], const size_t lens[], const void *d, void *rs[], void *ss[], int count, int sha2_ndx);
+int ecdsa_ctx_verify(ecdsa_ctx_t *ctx, const void *msg, size_t len, const ecdsa_p256_t *Q, const void *r, const void *s, int sha2_ndx);
+/*
+ * 일괄 검증은 서명마다 R = kG를 점으로 복원해 식에 넣어야 하는데, (r, s)만으로는 R의 y를 정할 수 없다.
+ * 그래서 서명 외에 ecdsa_*_sign_recid()가 돌려준 복원 색인 recids[i]를 더 받는다. recids가 NULL이거나
+ * recids[i]가 음수인 서명은 묶지 않고 하나씩 검증하므로, 복원 색인 없이 부르면 개별 검증을 반복하는 것과
+ * 같다. 묶음으로 빨라지려면 서명할 때 ecdsa_*_sign_recid()로 복원 색인을 함께 받아 두어야 한다.
+ */
+int ecdsa_ctx_verify_batch(ecdsa_ctx_t *ctx, const void *msgs[], const size_t lens[], const ecdsa_p256_t Qs[], const void *rs[], const void *ss[], const int recids[], int count, int results[], int sha2_ndx);
+int ecdsa_ctx_recover(ecdsa_ctx_t *ctx, const void *msg, size_t len, const void *r, const void *s, int recid, ecdsa_p256_t *Q, int sha2_ndx);
+void ecdsa_ctx_cache_budget(ecdsa_ctx_t *ctx, size_t bytes);
+void ecdsa_ctx_cache_stats(const ecdsa_ctx_t *ctx, unsigned long *hits, unsigned long *misses);
+
+int ecdh_p256(const void *d, const ecdsa_p256_t *Q, void *z);
+int ecdsa_p256_compress(unsigned char *out, const ecdsa_p256_t *Q);
+int ecdsa_p256_decompress(ecdsa_p256_t *Q, const unsigned char *in);
+
+/*
+ * 배경 스레드가 메시지와 무관한 (k^-1, r)을 미리 만들어 두는 서명 풀이다.
+ * 여러 스레드가 한 풀로 동시에 서명할 수 있다.
+ */
+typedef struct ecdsa_pool ecdsa_pool_t;
+
+ecdsa_pool_t *ecdsa_pool_new(int size);
+void ecdsa_pool_free(ecdsa_pool_t *pool);
+int ecdsa_pool_sign(ecdsa_pool_t *pool, const void *msg, size_t len, const void *d, void *r, void *s, int sha2_ndx);
+
+/*
+ * ECDSA_STATS를 정의하고 컴파일하면 P-256 서명과 검증이 단계별로 걸린 시간을 누적한다.
+ * 단위는 x86에서는 CPU 사이클(TSC), 그 밖에서는 나노초이다. 정의하지 않으면 계측 코드가 모두 빠지고
+ * ecdsa_stats_get()은 0으로 채운 값을 주며 0을 반환한다.
+ */
+#define ECDSA_STAT_HASH   0     // 메시지 해시와 RFC 6979의 HMAC-DRBG
+#define ECDSA_STAT_MUL    1     // 스칼라 곱셈
+#define ECDSA_STAT_INV    2     // 스칼라 역원과 좌표 정규화의 역원
+#define ECDSA_STAT_CMP    3     // 검증의 마지막 비교
+#define ECDSA_STAT_MISC   4     // 바이트 변환과 나머지 스칼라 연산
+#define ECDSA_STAT_PHASES 5
+
+typedef struct {
+    unsigned long long sign_calls, verify_calls;
+    unsigned long long sign[ECDSA_STAT_PHASES], verify[ECDSA_STAT_PHASES];
+} ecdsa_stats_t;
+
+int ecdsa_stats_get(ecdsa_stats_t *st);
+void ecdsa_stats_reset(void);
+
+/*
+ * 아래 함수들은 ecdsa_p256_init()이 만드는 기본 문맥 하나를 쓴다.
+ */
+int ecdsa_p256_init(void);
 void ecdsa_p256_clear(void);
 void ecdsa_p256_key(void *d, ecdsa_p256_t *Q);
+void ecdsa_p256_key_x4(void *d[4], ecdsa_p256_t Q[4]);
 int ecdsa_p256_sign(const void *msg, size_t len, const void *d, void *r, void *s, int sha2_ndx);
+int ecdsa_p256_sign_recid(const void *msg, size_t len, const void *d, void *r, void *s, int *recid, int sha2_ndx);
+int ecdsa_p256_sign_batch(const void *msgs[], const size_t lens[], const void *d, void *rs[], void *ss[], int count, int sha2_ndx);
 int ecdsa_p256_verify(const void *msg, size_t len, const ecdsa_p256_t *Q, const void *r, const void *s, int sha2_ndx);
+// recids는 ecdsa_ctx_verify_batch()와 같이 복원 색인이며 NULL일 수 있다
+int ecdsa_p256_verify_batch(const void *msgs[], const size_t lens[], const ecdsa_p256_t Qs[], const void *rs[], const void *ss[], const int recids[], int count, int results[], int sha2_ndx);
+int ecdsa_p256_recover(const void *msg, size_t len, const void *r, const void *s, int recid, ecdsa_p256_t *Q, int sha2_ndx);
+void ecdsa_p256_cache_budget(size_t bytes);
+void ecdsa_p256_cache_stats(unsigned long *hits, unsigned long *misses);
 void point_double(const mpz_t Qx, const mpz_t Qy, mpz_t Rx, mpz_t Ry, const mpz_t p);
 void point_add(const mpz_t Q1x, const mpz_t Q1y, const mpz_t Q2x, const mpz_t Q2y, mpz_t Rx, mpz_t Ry, const mpz_t p);
 
@@ -0,0 +1,1100 @@
+/*
+ * Copyright(c) 2020-2023 All rights reserved by Heekuck Oh.
+ * 이 프로그램은 한양대학교 ERICA 컴퓨터학부 학생을 위한 교육용으로 제작되었다.
+ * 한양대학교 ERICA 학생이 아닌 자는 이 프로그램을 수정하거나 배포할 수 없다.
+ * 프로그램을 수정할 경우 날짜, 학과, 학번, 이름, 수정 내용을 기록한다.
+ */
+
+#ifdef __linux__
+#include <bsd/stdlib.h>
+#elif __APPLE__
+#include <stdlib.h>
+#else
+#include <stdlib.h>
+#endif
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include "ed25519.h"
+#include "sha2.h"
+
+typedef unsigned __int128 u128;
+
+/*
+ * GF(p)의 원소로 p = 2^255 - 19이다. 51비트 림 5개로 나타내며(v = Σ v_i * 2^(51i)), 림은 64비트에
+ * 들어가므로 덧셈은 올림 없이 하고 곱셈에서 한꺼번에 정리한다. 곱셈과 제곱은 입력 림이 2^54보다 작으면
+ * 되고 출력 림은 2^52보다 작다. 2^255 = 19 (mod p)이므로 위쪽 림으로 넘친 부분은 19를 곱해 접는다.
+ */
+typedef uint64_t ed_fe[5];
+
+#define MASK51 0x7ffffffffffffULL
+
+static const ed_fe ED_D = {0x34dca135978a3ULL, 0x1a8283b156ebdULL, 0x5e7a26001c029ULL, 0x739c663a03cbbULL, 0x52036cee2b6ffULL};
+static const ed_fe ED_D2 = {0x69b9426b2f159ULL, 0x35050762add7aULL, 0x3cf44c0038052ULL, 0x6738cc7407977ULL, 0x2406d9dc56dffULL};
+static const ed_fe ED_SQRTM1 = {0x61b274a0ea0b0ULL, 0x0d5a5fc8f189dULL, 0x7ef5e9cbd0c60ULL, 0x78595a6804c9eULL, 0x2b8324804fc1dULL};
+static const ed_fe ED_BX = {0x62d608f25d51aULL, 0x412a4b4f6592aULL, 0x75b7171a4b31dULL, 0x1ff60527118feULL, 0x216936d3cd6e5ULL};
+static const ed_fe ED_BY = {0x6666666666658ULL, 0x4ccccccccccccULL, 0x1999999999999ULL, 0x3333333333333ULL, 0x6666666666666ULL};
+
+static void ed_fe_set_ui(ed_fe r, uint64_t a)
+{
+    r[0] = a;
+    r[1] = r[2] = r[3] = r[4] = 0;
+}
+
+static void ed_fe_add(ed_fe r, const ed_fe a, const ed_fe b)
+{
+    int i;
+    for (i = 0; i < 5; i++)
+        r[i] = a[i] + b[i];
+}
+
+// 림을 51비트로 정리한다. 맨 위의 올림은 19를 곱해 맨 아래로 보낸다
+static void ed_fe_carry(ed_fe r)
+{
+    uint64_t c;
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        c = r[i] >> 51;
+        r[i] &= MASK51;
+        r[i+1] += c;
+    }
+    c = r[4] >> 51;
+    r[4] &= MASK51;
+    r[0] += 19 * c;
+}
+
+// r = a - b. b의 림이 2^53보다 작으면 되도록 4p를 더한 뒤 뺀다
+static void ed_fe_sub(ed_fe r, const ed_fe a, const ed_fe b)
+{
+    r[0] = a[0] + 0x1fffffffffffb4ULL - b[0];
+    r[1] = a[1] + 0x1ffffffffffffcULL - b[1];
+    r[2] = a[2] + 0x1ffffffffffffcULL - b[2];
+    r[3] = a[3] + 0x1ffffffffffffcULL - b[3];
+    r[4] = a[4] + 0x1ffffffffffffcULL - b[4];
+    ed_fe_carry(r);
+}
+
+static void ed_fe_neg(ed_fe r, const ed_fe a)
+{
+    static const ed_fe zero = {0, 0, 0, 0, 0};
+    ed_fe_sub(r, zero, a);
+}
+
+// 128비트 누적값 t[0..4]의 올림을 정리해 r에 넣는다
+static void ed_fe_carry_wide(ed_fe r, u128 t[5])
+{
+    u128 c;
+
+    t[1] += t[0] >> 51;
+    r[0] = (uint64_t)t[0] & MASK51;
+    t[2] += t[1] >> 51;
+    r[1] = (uint64_t)t[1] & MASK51;
+    t[3] += t[2] >> 51;
+    r[2] = (uint64_t)t[2] & MASK51;
+    t[4] += t[3] >> 51;
+    r[3] = (uint64_t)t[3] & MASK51;
+    c = (u128)r[0] + (t[4] >> 51) * 19;
+    r[4] = (uint64_t)t[4] & MASK51;
+    r[0] = (uint64_t)c & MASK51;
+    r[1] += (uint64_t)(c >> 51);
+}
+
+static void ed_fe_mul(ed_fe r, const ed_fe a, const ed_fe b)
+{
+    uint64_t b1 = 19 * b[1], b2 = 19 * b[2], b3 = 19 * b[3], b4 = 19 * b[4];
+    u128 t[5];
+
+    t[0] = (u128)a[0]*b[0] + (u128)a[1]*b4 + (u128)a[2]*b3 + (u128)a[3]*b2 + (u128)a[4]*b1;
+    t[1] = (u128)a[0]*b[1] + (u128)a[1]*b[0] + (u128)a[2]*b4 + (u128)a[3]*b3 + (u128)a[4]*b2;
+    t[2] = (u128)a[0]*b[2] + (u128)a[1]*b[1] + (u128)a[2]*b[0] + (u128)a[3]*b4 + (u128)a[4]*b3;
+    t[3] = (u128)a[0]*b[3] + (u128)a[1]*b[2] + (u128)a[2]*b[1] + (u128)a[3]*b[0] + (u128)a[4]*b4;
+    t[4] = (u128)a[0]*b[4] + (u128)a[1]*b[3] + (u128)a[2]*b[2] + (u128)a[3]*b[1] + (u128)a[4]*b[0];
+    ed_fe_carry_wide(r, t);
+}
+
+// 교차항을 한 번만 곱하는 제곱이다
+static void ed_fe_sqr(ed_fe r, const ed_fe a)
+{
+    uint64_t d0 = 2 * a[0], d1 = 2 * a[1], d3 = 38 * a[3], a4 = 19 * a[4];
+    u128 t[5];
+
+    t[0] = (u128)a[0]*a[0] + (u128)d1*a4 + (u128)(2*a[2])*(19*a[3]);
+    t[1] = (u128)d0*a[1] + (u128)(2*a[2])*a4 + (u128)a[3]*(19*a[3]);
+    t[2] = (u128)d0*a[2] + (u128)a[1]*a[1] + (u128)d3*a[4];
+    t[3] = (u128)d0*a[3] + (u128)d1*a[2] + (u128)a[4]*a4;
+    t[4] = (u128)d0*a[4] + (u128)d1*a[3] + (u128)a[2]*a[2];
+    ed_fe_carry_wide(r, t);
+}
+
+// r = a^(2^k)
+static void ed_fe_sqr_n(ed_fe r, const ed_fe a, int k)
+{
+    ed_fe_sqr(r, a);
+    while (--k > 0)
+        ed_fe_sqr(r, r);
+}
+
+/*
+ * ed_fe_pow_chain() - x_250 = a^(2^250 - 1)과 a^11을 구한다. 역원 a^(p-2) = a^(2^255 - 21)과
+ * 제곱근에 쓰는 a^((p-5)/8) = a^(2^252 - 3)은 모두 이 값에서 제곱 몇 번으로 얻는다.
+ */
+static void ed_fe_pow_chain(ed_fe x250, ed_fe a11, const ed_fe a)
+{
+    ed_fe a2, a9, x5, x10, x20, x50, x100, t;
+
+    ed_fe_sqr(a2, a);
+    ed_fe_sqr_n(t, a2, 2);
+    ed_fe_mul(a9, t, a);
+    ed_fe_mul(a11, a9, a2);
+    ed_fe_sqr(t, a11);
+    ed_fe_mul(x5, t, a9);               // 2^5 - 1
+    ed_fe_sqr_n(t, x5, 5);
+    ed_fe_mul(x10, t, x5);              // 2^10 - 1
+    ed_fe_sqr_n(t, x10, 10);
+    ed_fe_mul(x20, t, x10);             // 2^20 - 1
+    ed_fe_sqr_n(t, x20, 20);
+    ed_fe_mul(t, t, x20);               // 2^40 - 1
+    ed_fe_sqr_n(t, t, 10);
+    ed_fe_mul(x50, t, x10);             // 2^50 - 1
+    ed_fe_sqr_n(t, x50, 50);
+    ed_fe_mul(x100, t, x50);            // 2^100 - 1
+    ed_fe_sqr_n(t, x100, 100);
+    ed_fe_mul(t, t, x100);              // 2^200 - 1
+    ed_fe_sqr_n(t, t, 50);
+    ed_fe_mul(x250, t, x50);            // 2^250 - 1
+}
+
+static void ed_fe_inv(ed_fe r, const ed_fe a)
+{
+    ed_fe x250, a11;
+
+    ed_fe_pow_chain(x250, a11, a);
+    ed_fe_sqr_n(x250, x250, 5);
+    ed_fe_mul(r, x250, a11);            // 2^255 - 32 + 11
+}
+
+static void ed_fe_pow22523(ed_fe r, const ed_fe a)
+{
+    ed_fe x250, a11;
+
+    ed_fe_pow_chain(x250, a11, a);
+    ed_fe_sqr_n(x250, x250, 2);
+    ed_fe_mul(r, x250, a);              // 2^252 - 4 + 1
+}
+
+// 리틀 엔디안 32바이트를 읽는다. 최상위 비트는 무시하며, 값이 p 이상이면 0을 반환한다
+static int ed_fe_from_bytes(ed_fe r, const unsigned char *in)
+{
+    uint64_t w[4];
+    int i, j;
+
+    for (i = 0; i < 4; i++)
+        for (w[i] = 0, j = 7; j >= 0; j--)
+            w[i] = (w[i] << 8) | in[8*i + j];
+    w[3] &= 0x7fffffffffffffffULL;
+    r[0] = w[0] & MASK51;
+    r[1] = ((w[0] >> 51) | (w[1] << 13)) & MASK51;
+    r[2] = ((w[1] >> 38) | (w[2] << 26)) & MASK51;
+    r[3] = ((w[2] >> 25) | (w[3] << 39)) & MASK51;
+    r[4] = w[3] >> 12;
+    // p 이상인 값은 위의 림이 모두 1이고 맨 아래 림이 2^51 - 19 이상이다
+    return !((r[1] & r[2] & r[3] & r[4]) == MASK51 && r[0] >= MASK51 - 18);
+}
+
+// [0, p)로 완전히 축약해 리틀 엔디안 32바이트로 쓴다
+static void ed_fe_to_bytes(unsigned char *out, const ed_fe a)
+{
+    uint64_t t[5], q, w[4];
+    int i, j;
+
+    memcpy(t, a, sizeof(t));
+    ed_fe_carry(t);
+    ed_fe_carry(t);
+    // t + 19 >= 2^255이면 t >= p이므로 q = 1이다
+    q = (t[0] + 19) >> 51;
+    for (i = 1; i < 5; i++)
+        q = (t[i] + q) >> 51;
+    t[0] += 19 * q;
+    for (i = 0; i < 4; i++) {
+        t[i+1] += t[i] >> 51;
+        t[i] &= MASK51;
+    }
+    t[4] &= MASK51;
+    w[0] = t[0] | (t[1] << 51);
+    w[1] = (t[1] >> 13) | (t[2] << 38);
+    w[2] = (t[2] >> 26) | (t[3] << 25);
+    w[3] = (t[3] >> 39) | (t[4] << 12);
+    for (i = 0; i < 4; i++)
+        for (j = 0; j < 8; j++)
+            out[8*i + j] = (unsigned char)(w[i] >> (8*j));
+}
+
+static int ed_fe_is_zero(const ed_fe a)
+{
+    unsigned char s[32], t = 0;
+    int i;
+
+    ed_fe_to_bytes(s, a);
+    for (i = 0; i < 32; i++)
+        t |= s[i];
+    return t == 0;
+}
+
+static int ed_fe_is_odd(const ed_fe a)
+{
+    unsigned char s[32];
+
+    ed_fe_to_bytes(s, a);
+    return s[0] & 1;
+}
+
+static void ed_fe_cmov(ed_fe r, const ed_fe a, int flag)
+{
+    uint64_t mask = -(uint64_t)(flag != 0);
+    int i;
+    for (i = 0; i < 5; i++)
+        r[i] ^= mask & (r[i] ^ a[i]);
+}
+
+/*
+ * 위수 L = 2^252 + 27742317777372353535851937790883648493에 대한 스칼라 연산. p256_sc처럼 64비트 림 4개에
+ * [0, L) 범위의 일반 정수를 담고 곱셈만 내부에서 몽고메리 곱셈(R = 2^256)을 쓴다. 바이트 형식은 리틀 엔디안이다.
+ */
+typedef uint64_t ed_sc[4];
+
+static const uint64_t ED_L[4] = {
+    0x5812631a5cf5d3edULL, 0x14def9dea2f79cd6ULL, 0x0000000000000000ULL, 0x1000000000000000ULL
+};
+// 몽고메리 곱셈에 사용하는 -L^-1 mod 2^64와 R^2 mod L
+static const uint64_t ED_L0 = 0xd2b51da312547e1bULL;
+static const uint64_t ED_RR[4] = {
+    0xa40611e3449c0f01ULL, 0xd00e1ba768859347ULL, 0xceec73d217f5be65ULL, 0x0399411b7c309a3dULL
+};
+
+// r = a - b, 빌림수를 반환한다
+static uint64_t ed_sc_sub4(uint64_t r[4], const uint64_t a[4], const uint64_t b[4])
+{
+    uint64_t borrow = 0, t, u;
+    int i;
+    for (i = 0; i < 4; i++) {
+        t = a[i] - b[i];
+        u = (a[i] < b[i]) | (t < borrow);
+        r[i] = t - borrow;
+        borrow = u;
+    }
+    return borrow;
+}
+
+// 몽고메리 곱셈 r = a*b*R^-1 mod L (CIOS 방식). a < 2^256, b < L이면 된다
+static void ed_sc_montmul(ed_sc r, const uint64_t a[4], const uint64_t b[4])
+{
+    uint64_t t[6], carry, m, u[4], borrow, mask;
+    u128 acc;
+    int i, j;
+
+    memset(t, 0, sizeof(t));
+    for (i = 0; i < 4; i++) {
+        carry = 0;
+        for (j = 0; j < 4; j++) {
+            acc = (u128)a[i] * b[j] + t[j] + carry;
+            t[j] = (uint64_t)acc;
+            carry = (uint64_t)(acc >> 64);
+        }
+        acc = (u128)t[4] + carry;
+        t[4] = (uint64_t)acc;
+        t[5] = (uint64_t)(acc >> 64);
+        m = t[0] * ED_L0;
+        acc = (u128)m * ED_L[0] + t[0];
+        carry = (uint64_t)(acc >> 64);
+        for (j = 1; j < 4; j++) {
+            acc = (u128)m * ED_L[j] + t[j] + carry;
+            t[j-1] = (uint64_t)acc;
+            carry = (uint64_t)(acc >> 64);
+        }
+        acc = (u128)t[4] + carry;
+        t[3] = (uint64_t)acc;
+        t[4] = t[5] + (uint64_t)(acc >> 64);
+    }
+    borrow = ed_sc_sub4(u, t, ED_L);
+    mask = -(t[4] | (borrow ^ 1));
+    for (i = 0; i < 4; i++)
+        r[i] = t[i] ^ (mask & (t[i] ^ u[i]));
+}
+
+static void ed_sc_add(ed_sc r, const ed_sc a, const ed_sc b)
+{
+    uint64_t s[4], t[4], mask;
+    u128 acc = 0;
+    int i;
+
+    // a, b < L < 2^253이므로 합은 넘치지 않는다
+    for (i = 0; i < 4; i++) {
+        acc += (u128)a[i] + b[i];
+        s[i] = (uint64_t)acc;
+        acc >>= 64;
+    }
+    mask = ed_sc_sub4(t, s, ED_L) - 1;
+    for (i = 0; i < 4; i++)
+        r[i] = s[i] ^ (mask & (s[i] ^ t[i]));
+}
+
+// r = a*b mod L. a < 2^256, b < L이면 된다
+static void ed_sc_mul(ed_sc r, const uint64_t a[4], const ed_sc b)
+{
+    ed_sc t;
+    ed_sc_montmul(t, a, b);
+    ed_sc_montmul(r, t, ED_RR);
+}
+
+static void ed_sc_load(uint64_t r[4], const unsigned char *in)
+{
+    int i, j;
+    for (i = 0; i < 4; i++)
+        for (r[i] = 0, j = 7; j >= 0; j--)
+            r[i] = (r[i] << 8) | in[8*i + j];
+}
+
+static void ed_sc_store(unsigned char *out, const ed_sc a)
+{
+    int i, j;
+    for (i = 0; i < 4; i++)
+        for (j = 0; j < 8; j++)
+            out[8*i + j] = (unsigned char)(a[i] >> (8*j));
+}
+
+// 리틀 엔디안 64바이트 x = lo + hi*2^256을 mod L로 줄인다. hi*R과 lo를 각각 몽고메리 곱셈으로 구해 더한다
+static void ed_sc_reduce64(ed_sc r, const unsigned char in[64])
+{
+    static const uint64_t one[4] = {1, 0, 0, 0};
+    uint64_t lo[4], hi[4];
+
+    ed_sc_load(lo, in);
+    ed_sc_load(hi, in + 32);
+    ed_sc_montmul(hi, hi, ED_RR);       // hi*R mod L
+    ed_sc_montmul(lo, lo, ED_RR);
+    ed_sc_montmul(lo, lo, one);         // lo mod L
+    ed_sc_add(r, lo, hi);
+}
+
+// 32바이트 S를 읽는다. S < L이면 1을 반환한다
+static int ed_sc_from_bytes(ed_sc r, const unsigned char *in)
+{
+    uint64_t t[4];
+
+    ed_sc_load(r, in);
+    return ed_sc_sub4(t, r, ED_L) != 0;
+}
+
+/*
+ * 꼬인 에드워즈 곡선 -x^2 + y^2 = 1 + d x^2 y^2 위의 점. Hisil 등의 확장 좌표 (X : Y : Z : T)를 쓰며
+ * x = X/Z, y = Y/Z, xy = T/Z이다. 덧셈 공식은 a = -1에서 예외가 없으므로 O나 같은 점도 따로 처리하지 않고,
+ * 역원 없이 계산하다가 바이트로 바꿀 때 한 번만 역원을 구한다. 중간 결과는 ref10처럼
+ * 완성 좌표 ((X : Z), (Y : T))로 두었다가 다음 연산에 필요한 만큼만 곱해서 확장 좌표로 되돌린다.
+ */
+typedef struct {
+    ed_fe X, Y, Z, T;
+} ed_point_t;
+
+// 덧셈 결과인 완성 좌표로 x = X/Z, y = Y/T이다
+typedef struct {
+    ed_fe X, Y, Z, T;
+} ed_completed_t;
+
+// 더해질 점을 (Y + X, Y - X, Z, 2dT)로 미리 바꾼 형태이다
+typedef struct {
+    ed_fe YplusX, YminusX, Z, T2d;
+} ed_cached_t;
+
+// 고정 기저 표의 아핀 점으로 (y + x, y - x, 2dxy)를 저장한다
+typedef struct {
+    ed_fe yplusx, yminusx, xy2d;
+} ed_precomp_t;
+
+static void ed_point_identity(ed_point_t *P)
+{
+    ed_fe_set_ui(P->X, 0);
+    ed_fe_set_ui(P->Y, 1);
+    ed_fe_set_ui(P->Z, 1);
+    ed_fe_set_ui(P->T, 0);
+}
+
+// 두배 연산의 입력에는 T가 필요 없으므로 곱셈 하나를 아낀다
+static void ed_completed_to_proj(ed_point_t *P, const ed_completed_t *C)
+{
+    ed_fe_mul(P->X, C->X, C->T);
+    ed_fe_mul(P->Y, C->Y, C->Z);
+    ed_fe_mul(P->Z, C->Z, C->T);
+}
+
+static void ed_completed_to_point(ed_point_t *P, const ed_completed_t *C)
+{
+    ed_fe_mul(P->X, C->X, C->T);
+    ed_fe_mul(P->Y, C->Y, C->Z);
+    ed_fe_mul(P->Z, C->Z, C->T);
+    ed_fe_mul(P->T, C->X, C->Y);
+}
+
+static void ed_point_to_cached(ed_cached_t *C, const ed_point_t *P)
+{
+    ed_fe_add(C->YplusX, P->Y, P->X);
+    ed_fe_sub(C->YminusX, P->Y, P->X);
+    memcpy(C->Z, P->Z, sizeof(ed_fe));
+    ed_fe_mul(C->T2d, P->T, ED_D2);
+}
+
+static void ed_cached_neg(ed_cached_t *C)
+{
+    ed_fe t;
+
+    memcpy(t, C->YplusX, sizeof(ed_fe));
+    memcpy(C->YplusX, C->YminusX, sizeof(ed_fe));
+    memcpy(C->YminusX, t, sizeof(ed_fe));
+    ed_fe_neg(C->T2d, C->T2d);
+}
+
+// R = 2P (dbl-2008-hwcd). P의 T는 읽지 않는다
+static void ed_double(ed_completed_t *R, const ed_point_t *P)
+{
+    ed_fe t0;
+
+    ed_fe_sqr(R->X, P->X);
+    ed_fe_sqr(R->Z, P->Y);
+    ed_fe_sqr(R->T, P->Z);
+    ed_fe_add(R->T, R->T, R->T);
+    ed_fe_add(R->Y, P->X, P->Y);
+    ed_fe_sqr(t0, R->Y);
+    ed_fe_add(R->Y, R->Z, R->X);
+    ed_fe_sub(R->Z, R->Z, R->X);
+    ed_fe_sub(R->X, t0, R->Y);
+    ed_fe_sub(R->T, R->T, R->Z);
+}
+
+// R = P + Q (add-2008-hwcd-3)
+static void ed_add(ed_completed_t *R, const ed_point_t *P, const ed_cached_t *Q)
+{
+    ed_fe t0;
+
+    ed_fe_add(R->X, P->Y, P->X);
+    ed_fe_sub(R->Y, P->Y, P->X);
+    ed_fe_mul(R->Z, R->X, Q->YplusX);
+    ed_fe_mul(R->Y, R->Y, Q->YminusX);
+    ed_fe_mul(R->T, Q->T2d, P->T);
+    ed_fe_mul(R->X, P->Z, Q->Z);
+    ed_fe_add(t0, R->X, R->X);
+    ed_fe_sub(R->X, R->Z, R->Y);
+    ed_fe_add(R->Y, R->Z, R->Y);
+    ed_fe_add(R->Z, t0, R->T);
+    ed_fe_sub(R->T, t0, R->T);
+}
+
+// R = P + Q로 Q의 Z = 1이므로 곱셈 하나를 아낀다
+static void ed_madd(ed_completed_t *R, const ed_point_t *P, const ed_precomp_t *Q)
+{
+    ed_fe t0;
+
+    ed_fe_add(R->X, P->Y, P->X);
+    ed_fe_sub(R->Y, P->Y, P->X);
+    ed_fe_mul(R->Z, R->X, Q->yplusx);
+    ed_fe_mul(R->Y, R->Y, Q->yminusx);
+    ed_fe_mul(R->T, Q->xy2d, P->T);
+    ed_fe_add(t0, P->Z, P->Z);
+    ed_fe_sub(R->X, R->Z, R->Y);
+    ed_fe_add(R->Y, R->Z, R->Y);
+    ed_fe_add(R->Z, t0, R->T);
+    ed_fe_sub(R->T, t0, R->T);
+}
+
+// P = P + Q
+static void ed_point_add(ed_point_t *P, const ed_cached_t *Q)
+{
+    ed_completed_t R;
+
+    ed_add(&R, P, Q);
+    ed_completed_to_point(P, &R);
+}
+
+// P = 2^k P
+static void ed_point_double_n(ed_point_t *P, int k)
+{
+    ed_completed_t R;
+
+    while (k-- > 1) {
+        ed_double(&R, P);
+        ed_completed_to_proj(P, &R);
+    }
+    ed_double(&R, P);
+    ed_completed_to_point(P, &R);
+}
+
+// 8P = O이면, 즉 P가 위수 8의 부분군에 있으면 1을 반환한다. X = 0, Y = Z인지 확인한다
+static int ed_point_is_small(const ed_point_t *P)
+{
+    ed_point_t Q = *P;
+    ed_fe t;
+
+    ed_point_double_n(&Q, 3);
+    ed_fe_sub(t, Q.Y, Q.Z);
+    return ed_fe_is_zero(Q.X) && ed_fe_is_zero(t);
+}
+
+static void ed_point_to_bytes(unsigned char *out, const ed_point_t *P)
+{
+    ed_fe zinv, x, y;
+
+    ed_fe_inv(zinv, P->Z);
+    ed_fe_mul(x, P->X, zinv);
+    ed_fe_mul(y, P->Y, zinv);
+    ed_fe_to_bytes(out, y);
+    out[31] |= (unsigned char)(ed_fe_is_odd(x) << 7);
+}
+
+/*
+ * ed_point_from_bytes() - RFC 8032 5.1.3으로 점을 복원한다. y >= p이거나 x^2 = (y^2 - 1)/(dy^2 + 1)의
+ * 제곱근이 없거나 x = 0인데 부호 비트가 1이면 0을 반환한다. 제곱근은 x = uv^3 (uv^7)^((p-5)/8)로 구한다.
+ */
+static int ed_point_from_bytes(ed_point_t *P, const unsigned char *in)
+{
+    ed_fe u, v, v3, vxx, t;
+    int sign = in[31] >> 7;
+
+    if (!ed_fe_from_bytes(P->Y, in))
+        return 0;
+    ed_fe_set_ui(P->Z, 1);
+    ed_fe_sqr(u, P->Y);
+    ed_fe_mul(v, u, ED_D);
+    ed_fe_sub(u, u, P->Z);              // u = y^2 - 1
+    ed_fe_add(v, v, P->Z);              // v = dy^2 + 1
+
+    ed_fe_sqr(v3, v);
+    ed_fe_mul(v3, v3, v);
+    ed_fe_sqr(P->X, v3);
+    ed_fe_mul(P->X, P->X, v);
+    ed_fe_mul(P->X, P->X, u);           // uv^7
+    ed_fe_pow22523(P->X, P->X);
+    ed_fe_mul(P->X, P->X, v3);
+    ed_fe_mul(P->X, P->X, u);           // uv^3 (uv^7)^((p-5)/8)
+
+    ed_fe_sqr(vxx, P->X);
+    ed_fe_mul(vxx, vxx, v);
+    ed_fe_sub(t, vxx, u);
+    if (!ed_fe_is_zero(t)) {
+        ed_fe_add(t, vxx, u);
+        if (!ed_fe_is_zero(t))
+            return 0;
+        ed_fe_mul(P->X, P->X, ED_SQRTM1);
+    }
+    if (ed_fe_is_zero(P->X) && sign)
+        return 0;
+    if (ed_fe_is_odd(P->X) != sign)
+        ed_fe_neg(P->X, P->X);
+    ed_fe_mul(P->T, P->X, P->Y);
+    return 1;
+}
+
+/*
+ * 기저점 B의 고정 기저 표. 스칼라를 부호 있는 4비트 자리수 e_i ∈ [-8, 8] (i = 0..63)로 나누면
+ * aB = Σ e_i 16^i B이다. ED_BASE[i][j-1] = j * 256^i * B를 두면 홀수 자리의 합을 표 조회와 덧셈으로 구하고
+ * 두배 연산 네 번으로 16을 곱한 뒤 짝수 자리의 합을 더하면 된다. 표는 약 30KB로 처음 쓸 때 한 번 만든다.
+ */
+static ed_precomp_t ED_BASE[32][8];
+static pthread_once_t ed_base_once = PTHREAD_ONCE_INIT;
+
+static void ed_base_init(void)
+{
+    ed_point_t P, Q, pts[32][8];
+    ed_cached_t c;
+    ed_fe prod[256], inv, t, x, y;
+    int i, j, k;
+
+    memcpy(P.X, ED_BX, sizeof(ed_fe));
+    memcpy(P.Y, ED_BY, sizeof(ed_fe));
+    ed_fe_set_ui(P.Z, 1);
+    ed_fe_mul(P.T, ED_BX, ED_BY);
+    for (i = 0; i < 32; i++) {
+        ed_point_to_cached(&c, &P);
+        pts[i][0] = Q = P;
+        for (j = 1; j < 8; j++) {
+            ed_point_add(&Q, &c);
+            pts[i][j] = Q;
+        }
+        ed_point_double_n(&P, 8);
+    }
+    // Montgomery의 방법으로 Z 256개의 역원을 한 번의 역원 계산으로 구한다
+    memcpy(prod[0], pts[0][0].Z, sizeof(ed_fe));
+    for (k = 1; k < 256; k++)
+        ed_fe_mul(prod[k], prod[k-1], pts[k/8][k%8].Z);
+    ed_fe_inv(inv, prod[255]);
+    for (k = 255; k >= 0; k--) {
+        ed_point_t *R = &pts[k/8][k%8];
+        if (k > 0) {
+            ed_fe_mul(t, inv, prod[k-1]);
+            ed_fe_mul(inv, inv, R->Z);
+        }
+        else
+            memcpy(t, inv, sizeof(ed_fe));
+        ed_fe_mul(x, R->X, t);
+        ed_fe_mul(y, R->Y, t);
+        ed_fe_add(ED_BASE[k/8][k%8].yplusx, y, x);
+        ed_fe_sub(ED_BASE[k/8][k%8].yminusx, y, x);
+        ed_fe_mul(t, x, y);
+        ed_fe_mul(ED_BASE[k/8][k%8].xy2d, t, ED_D2);
+    }
+}
+
+// 32바이트 리틀 엔디안 a (a < 2^255)를 부호 있는 4비트 자리수 e_i ∈ [-8, 8]로 바꾼다
+static void ed_recode_signed4(signed char e[64], const unsigned char *a)
+{
+    int i, carry = 0;
+
+    for (i = 0; i < 32; i++) {
+        e[2*i] = a[i] & 15;
+        e[2*i+1] = (a[i] >> 4) & 15;
+    }
+    for (i = 0; i < 63; i++) {
+        e[i] += carry;
+        carry = (e[i] + 8) >> 4;
+        e[i] -= carry << 4;
+    }
+    e[63] += carry;
+}
+
+// 표의 한 줄에서 dB (d ∈ [-8, 8])를 분기 없이 고른다. d = 0이면 O = (1, 1, 0)이다
+static void ed_base_select(ed_precomp_t *T, int pos, int d)
+{
+    int j, neg = d < 0, abs = neg ? -d : d;
+    ed_fe t;
+
+    ed_fe_set_ui(T->yplusx, 1);
+    ed_fe_set_ui(T->yminusx, 1);
+    ed_fe_set_ui(T->xy2d, 0);
+    for (j = 0; j < 8; j++) {
+        ed_fe_cmov(T->yplusx, ED_BASE[pos][j].yplusx, j + 1 == abs);
+        ed_fe_cmov(T->yminusx, ED_BASE[pos][j].yminusx, j + 1 == abs);
+        ed_fe_cmov(T->xy2d, ED_BASE[pos][j].xy2d, j + 1 == abs);
+    }
+    memcpy(t, T->yplusx, sizeof(ed_fe));
+    ed_fe_cmov(T->yplusx, T->yminusx, neg);
+    ed_fe_cmov(T->yminusx, t, neg);
+    ed_fe_neg(t, T->xy2d);
+    ed_fe_cmov(T->xy2d, t, neg);
+}
+
+/*
+ * ed_mul_base() - R = aB를 고정 기저 표로 계산한다. 덧셈 64번과 두배 연산 네 번이며,
+ * 표 조회와 연산 순서는 a와 무관하다.
+ */
+static void ed_mul_base(ed_point_t *R, const unsigned char *a)
+{
+    signed char e[64];
+    ed_precomp_t T;
+    ed_completed_t C;
+    int i;
+
+    pthread_once(&ed_base_once, ed_base_init);
+    ed_recode_signed4(e, a);
+    ed_point_identity(R);
+    for (i = 1; i < 64; i += 2) {
+        ed_base_select(&T, i/2, e[i]);
+        ed_madd(&C, R, &T);
+        ed_completed_to_point(R, &C);
+    }
+    ed_point_double_n(R, 4);
+    for (i = 0; i < 64; i += 2) {
+        ed_base_select(&T, i/2, e[i]);
+        ed_madd(&C, R, &T);
+        ed_completed_to_point(R, &C);
+    }
+    memset(e, 0, sizeof(e));
+}
+
+/*
+ * ed_mul_vartime() - R = aP를 부호 있는 4비트 윈도우로 계산한다. 검증에서만 쓰므로 자리수로 표를
+ * 바로 조회하고 0인 자리수는 건너뛴다.
+ */
+static void ed_mul_vartime(ed_point_t *R, const unsigned char *a, const ed_point_t *P)
+{
+    signed char e[64];
+    ed_cached_t tbl[8], T;
+    ed_point_t Q = *P;
+    int i, d;
+
+    ed_point_to_cached(&tbl[0], P);
+    for (i = 1; i < 8; i++) {
+        ed_point_add(&Q, &tbl[0]);
+        ed_point_to_cached(&tbl[i], &Q);
+    }
+    ed_recode_signed4(e, a);
+    ed_point_identity(R);
+    for (i = 63; i >= 0; i--) {
+        if (i < 63)
+            ed_point_double_n(R, 4);
+        if ((d = e[i]) != 0) {
+            T = tbl[(d > 0 ? d : -d) - 1];
+            if (d < 0)
+                ed_cached_neg(&T);
+            ed_point_add(R, &T);
+        }
+    }
+}
+
+// SHA-512(a || b || msg). sha512_update()는 unsigned int 길이를 받으므로 긴 메시지는 나누어 넣는다
+static void ed_hash(unsigned char digest[SHA512_DIGEST_SIZE], const unsigned char *a, const unsigned char *b, const void *msg, size_t len)
+{
+    const unsigned char *m = msg;
+    sha512_ctx c;
+    size_t n;
+
+    sha512_init(&c);
+    if (a)
+        sha512_update(&c, a, 32);
+    if (b)
+        sha512_update(&c, b, 32);
+    for (; len > 0; len -= n, m += n) {
+        n = len > (1u << 30) ? (1u << 30) : len;
+        sha512_update(&c, m, (unsigned int)n);
+    }
+    sha512_final(&c, digest);
+}
+
+/*
+ * ed25519_seed_key(seed, sk, pk) - 32바이트 시드로 RFC 8032 5.1.5의 키를 만든다.
+ * H = SHA-512(seed)의 앞 32바이트를 고정(clamp)한 s로 pk = sB이고, sk는 seed || pk이다.
+ */
+void ed25519_seed_key(const void *seed, void *sk, void *pk)
+{
+    unsigned char h[SHA512_DIGEST_SIZE], A[ED25519_PUBLIC_BYTES];
+    ed_point_t P;
+
+    sha512(seed, 32, h);
+    h[0] &= 248;
+    h[31] &= 127;
+    h[31] |= 64;
+    ed_mul_base(&P, h);
+    ed_point_to_bytes(A, &P);
+    memmove(sk, seed, 32);
+    memcpy((unsigned char *)sk + 32, A, ED25519_PUBLIC_BYTES);
+    memcpy(pk, A, ED25519_PUBLIC_BYTES);
+    memset(h, 0, sizeof(h));
+}
+
+/*
+ * ed25519_key(sk, pk) - 무작위 시드로 Ed25519 비밀키 sk(64바이트)와 공개키 pk(32바이트)를 만든다.
+ */
+void ed25519_key(void *sk, void *pk)
+{
+    unsigned char seed[32];
+
+    arc4random_buf(seed, sizeof(seed));
+    ed25519_seed_key(seed, sk, pk);
+    memset(seed, 0, sizeof(seed));
+}
+
+/*
+ * ed25519_sign(msg, len, sk, sig) - RFC 8032 5.1.6으로 서명 sig = R || S (64바이트)를 만든다.
+ * r = H(prefix || M) mod L, R = rB, k = H(R || A || M) mod L, S = r + ks mod L이다.
+ * 논스가 결정적이므로 난수가 필요 없고, 고정 기저 곱셈 한 번 외에는 역원 계산이 R을 바이트로 바꿀 때의 한 번뿐이다.
+ */
+void ed25519_sign(const void *msg, size_t len, const void *sk, void *sig)
+{
+    const unsigned char *key = sk;
+    unsigned char h[SHA512_DIGEST_SIZE], d[SHA512_DIGEST_SIZE], *out = sig;
+    uint64_t s[4];
+    ed_sc r, k;
+    ed_point_t R;
+
+    sha512(key, 32, h);
+    h[0] &= 248;
+    h[31] &= 127;
+    h[31] |= 64;
+    ed_hash(d, h + 32, NULL, msg, len);
+    ed_sc_reduce64(r, d);
+    ed_sc_store(d, r);
+    ed_mul_base(&R, d);
+    ed_point_to_bytes(out, &R);
+    ed_hash(d, out, key + 32, msg, len);
+    ed_sc_reduce64(k, d);
+    ed_sc_load(s, h);
+    ed_sc_mul(k, s, k);
+    ed_sc_add(k, k, r);
+    ed_sc_store(out + 32, k);
+    memset(h, 0, sizeof(h));
+    memset(d, 0, sizeof(d));
+    memset(s, 0, sizeof(s));
+    memset(r, 0, sizeof(r));
+}
+
+/*
+ * ed25519_verify(msg, len, pk, sig) - 서명 sig를 공개키 pk로 검증한다. RFC 8032 5.1.7의
+ * 8SB = 8R + 8kA를 확인하는 방식으로, 일괄 검증과 같은 식을 쓰므로 두 결과가 항상 같다.
+ * A나 R의 인코딩이 올바르지 않거나 S >= L이면 오류 코드를 반환한다.
+ */
+int ed25519_verify(const void *msg, size_t len, const void *pk, const void *sig)
+{
+    const unsigned char *s = sig;
+    unsigned char d[SHA512_DIGEST_SIZE];
+    ed_point_t A, R, P, Q;
+    ed_cached_t c;
+    ed_sc S, k;
+
+    if (!ed_point_from_bytes(&A, pk))
+        return ED25519_POINT_INVALID;
+    if (!ed_point_from_bytes(&R, s) || !ed_sc_from_bytes(S, s + 32))
+        return ED25519_SIG_INVALID;
+
+    ed_hash(d, s, pk, msg, len);
+    ed_sc_reduce64(k, d);
+    ed_sc_store(d, k);
+    ed_mul_vartime(&Q, d, &A);          // kA
+    ed_point_to_cached(&c, &R);
+    ed_point_add(&Q, &c);               // R + kA
+    ed_mul_base(&P, s + 32);            // SB
+    ed_point_to_cached(&c, &Q);
+    ed_cached_neg(&c);
+    ed_point_add(&P, &c);
+    if (!ed_point_is_small(&P))
+        return ED25519_SIG_MISMATCH;
+    return 0;
+}
+
+/*
+ * 일괄 검증은 128비트 난수 z_i로 8(Σ z_i R_i + Σ (z_i k_i) A_i - (Σ z_i S_i) B) = O를 한 번에 확인한다.
+ * B의 계수는 하나로 모아 고정 기저 표로 계산하고, 나머지 2*count개 항은 ECDSA의 ecc_msm()과 같은
+ * Pippenger 버킷 방법으로 계산한다. 식이 성립하지 않으면 반씩 나누어 실패한 서명을 찾는다.
+ */
+typedef struct {
+    const void **msgs;
+    const size_t *lens;
+    const void **pks, **sigs;
+    int *idx;
+    ed_sc *g, *k;
+    ed_cached_t *P;
+} ed_batch_t;
+
+// 이보다 적은 수의 서명은 묶어서 확인하는 것보다 하나씩 검증하는 편이 빠르다
+#define ED25519_BATCH_MIN 4
+
+static int ed_sc_bits(const ed_sc k, int pos, int c)
+{
+    uint64_t v;
+
+    if (pos >= 256)
+        return 0;
+    v = k[pos/64] >> (pos%64);
+    if (pos%64 + c > 64 && pos/64 < 3)
+        v |= k[pos/64 + 1] << (64 - pos%64);
+    return (int)(v & ((1u << c) - 1));
+}
+
+/*
+ * ed_msm() - R = Σ k_i P_i를 Pippenger의 버킷 방법으로 계산한다. 스칼라는 L보다 작으므로 253비트를
+ * c비트의 부호 있는 자리수로 나누며, c는 ecc_msm()과 같이 (창의 수) * (cnt + 버킷 수)가 가장 작도록 고른다.
+ * 메모리를 할당하지 못하면 -1을 반환한다.
+ */
+static int ed_msm(ed_point_t *R, const ed_cached_t *P, const ed_sc *k, int cnt)
+{
+    ed_point_t *bucket, S, T;
+    ed_cached_t A;
+    unsigned char *used;
+    short *d;
+    long cost, best = 0;
+    int c = 2, nb, win, i, j, w, v, carry;
+
+    for (i = 2; i <= 16; i++) {
+        cost = (long)(253/i + 1) * (cnt + (1 << (i-1)));
+        if (best == 0 || cost < best) {
+            best = cost;
+            c = i;
+        }
+    }
+    nb = 1 << (c-1);
+    win = 253/c + 1;
+    d = malloc(cnt * win * sizeof(short));
+    bucket = malloc(nb * sizeof(ed_point_t));
+    used = malloc(nb);
+    if (d == NULL || bucket == NULL || used == NULL) {
+        free(d);
+        free(bucket);
+        free(used);
+        return -1;
+    }
+    for (i = 0; i < cnt; i++)
+        for (w = 0, carry = 0; w < win; w++) {
+            v = ed_sc_bits(k[i], w*c, c) + carry;
+            carry = (v + nb) >> c;
+            d[i*win + w] = (short)(v - (carry << c));
+        }
+
+    ed_point_identity(R);
+    for (w = win - 1; w >= 0; w--) {
+        if (w < win - 1)
+            ed_point_double_n(R, c);
+        memset(used, 0, nb);
+        for (i = 0; i < cnt; i++) {
+            if ((v = d[i*win + w]) == 0)
+                continue;
+            A = P[i];
+            if (v < 0) {
+                ed_cached_neg(&A);
+                v = -v;
+            }
+            if (!used[v-1]) {
+                ed_point_identity(&bucket[v-1]);
+                used[v-1] = 1;
+            }
+            ed_point_add(&bucket[v-1], &A);
+        }
+        // T = Σ j * B_j = B_nb + (B_nb + B_nb-1) + ... + (B_nb + ... + B_1)
+        ed_point_identity(&S);
+        ed_point_identity(&T);
+        for (j = nb - 1; j >= 0; j--) {
+            if (used[j]) {
+                ed_point_to_cached(&A, &bucket[j]);
+                ed_point_add(&S, &A);
+            }
+            ed_point_to_cached(&A, &S);
+            ed_point_add(&T, &A);
+        }
+        ed_point_to_cached(&A, &T);
+        ed_point_add(R, &A);
+    }
+    free(d);
+    free(bucket);
+    free(used);
+    return 0;
+}
+
+// 묶음의 [lo, hi) 범위에 대해 8(Σ k_i P_i - gB) = O이면 1, 아니면 0, 메모리를 할당하지 못하면 -1을 반환한다
+static int ed_batch_check(const ed_batch_t *b, int lo, int hi)
+{
+    unsigned char gb[32];
+    ed_sc g;
+    ed_point_t R, G;
+    ed_cached_t c;
+    int j;
+
+    memset(g, 0, sizeof(ed_sc));
+    for (j = lo; j < hi; j++)
+        ed_sc_add(g, g, b->g[j]);
+    ed_sc_store(gb, g);
+    ed_mul_base(&G, gb);
+    if (ed_msm(&R, b->P + 2*lo, (const ed_sc *)b->k + 2*lo, 2*(hi - lo)) != 0)
+        return -1;
+    ed_point_to_cached(&c, &G);
+    ed_cached_neg(&c);
+    ed_point_add(&R, &c);
+    return ed_point_is_small(&R);
+}
+
+// 묶음의 [lo, hi) 범위를 ed25519_verify()로 하나씩 검증한다
+static void ed_batch_each(const ed_batch_t *b, int lo, int hi, int results[])
+{
+    int j, i;
+
+    for (j = lo; j < hi; j++) {
+        i = b->idx[j];
+        results[i] = ed25519_verify(b->msgs[i], b->lens[i], b->pks[i], b->sigs[i]);
+    }
+}
+
+static void ed_batch_bisect(const ed_batch_t *b, int lo, int hi, int bad, int results[])
+{
+    int j, mid, ok;
+
+    if (hi - lo < ED25519_BATCH_MIN) {
+        ed_batch_each(b, lo, hi, results);
+        return;
+    }
+    if (!bad && (ok = ed_batch_check(b, lo, hi)) != 0) {
+        if (ok < 0)
+            ed_batch_each(b, lo, hi, results);
+        else
+            for (j = lo; j < hi; j++)
+                results[b->idx[j]] = 0;
+        return;
+    }
+    mid = lo + (hi - lo) / 2;
+    if ((ok = ed_batch_check(b, lo, mid)) > 0) {
+        for (j = lo; j < mid; j++)
+            results[b->idx[j]] = 0;
+        ed_batch_bisect(b, mid, hi, 1, results);
+    }
+    else if (ok < 0)
+        ed_batch_each(b, lo, hi, results);
+    else {
+        ed_batch_bisect(b, lo, mid, 1, results);
+        ed_batch_bisect(b, mid, hi, 0, results);
+    }
+}
+
+/*
+ * ed25519_verify_batch() - count개의 서명 (msgs[i], lens[i], pks[i], sigs[i])을 한꺼번에 검증한다.
+ * 각 서명의 결과는 ed25519_verify()와 같은 값으로 results[i]에 넣으며, 모두 올바르면 0,
+ * 하나라도 올바르지 않으면 ED25519_SIG_MISMATCH를 반환한다. 인코딩이 잘못된 서명은 묶음에 넣지 않고
+ * 바로 오류 코드를 정한다. 작업 공간을 할당하지 못하면 모든 서명을 하나씩 검증한다.
+ */
+int ed25519_verify_batch(const void *msgs[], const size_t lens[], const void *pks[], const void *sigs[], int count, int results[])
+{
+    unsigned char d[SHA512_DIGEST_SIZE];
+    const unsigned char *s;
+    ed_batch_t b;
+    ed_point_t A, R;
+    ed_sc S, k;
+    uint64_t z[4];
+    int i, j, m;
+
+    if (count <= 0)
+        return 0;
+    b.msgs = msgs;
+    b.lens = lens;
+    b.pks = pks;
+    b.sigs = sigs;
+    b.idx = malloc(count * sizeof(int));
+    b.g = malloc(count * sizeof(ed_sc));
+    b.k = malloc(2 * count * sizeof(ed_sc));
+    b.P = malloc(2 * count * sizeof(ed_cached_t));
+    if (b.idx == NULL || b.g == NULL || b.k == NULL || b.P == NULL) {
+        free(b.idx);
+        free(b.g);
+        free(b.k);
+        free(b.P);
+        for (i = 0, m = 0; i < count; i++)
+            if ((results[i] = ed25519_verify(msgs[i], lens[i], pks[i], sigs[i])) != 0)
+                m = ED25519_SIG_MISMATCH;
+        return m;
+    }
+
+    for (i = 0, m = 0; i < count; i++) {
+        s = sigs[i];
+        if (!ed_point_from_bytes(&A, pks[i])) {
+            results[i] = ED25519_POINT_INVALID;
+            continue;
+        }
+        if (!ed_point_from_bytes(&R, s) || !ed_sc_from_bytes(S, s + 32)) {
+            results[i] = ED25519_SIG_INVALID;
+            continue;
+        }
+        ed_hash(d, s, pks[i], msgs[i], lens[i]);
+        ed_sc_reduce64(k, d);
+        memset(z, 0, sizeof(z));
+        arc4random_buf(z, 16);
+        z[0] |= 1;
+        ed_sc_mul(b.g[m], z, S);            // z*S
+        ed_sc_mul(b.k[2*m], z, k);          // z*k
+        memcpy(b.k[2*m+1], z, sizeof(ed_sc));
+        ed_point_to_cached(&b.P[2*m], &A);
+        ed_point_to_cached(&b.P[2*m+1], &R);
+        b.idx[m++] = i;
+    }
+    if (m > 0)
+        ed_batch_bisect(&b, 0, m, 0, results);
+
+    free(b.idx);
+    free(b.g);
+    free(b.k);
+    free(b.P);
+    for (j = 0; j < count; j++)
+        if (results[j] != 0)
+            return ED25519_SIG_MISMATCH;
+    return 0;
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright(c) 2020-2023 All rights reserved by Heekuck Oh.
+ * 이 프로그램은 한양대학교 ERICA 컴퓨터학부 학생을 위한 교육용으로 제작되었다.
+ * 한양대학교 ERICA 학생이 아닌 자는 이 프로그램을 수정하거나 배포할 수 없다.
+ * 프로그램을 수정할 경우 날짜, 학과, 학번, 이름, 수정 내용을 기록한다.
+ */
+#ifndef _ED25519_H_
+#define _ED25519_H_
+#include <stddef.h>
+
+/*
+ * Ed25519(RFC 8032)의 공개키, 비밀키, 서명의 바이트 길이이다. 비밀키는 32바이트 시드 뒤에
+ * 공개키를 붙인 것으로, 서명할 때 공개키를 다시 계산하거나 따로 받지 않기 위한 것이다.
+ */
+#define ED25519_PUBLIC_BYTES 32
+#define ED25519_SECRET_BYTES 64
+#define ED25519_SIG_BYTES    64
+
+/*
+ * 오류 코드 목록으로 ECDSA와 같은 값을 쓴다. 오류가 없으면 0을 사용한다.
+ */
+#define ED25519_SIG_INVALID   2
+#define ED25519_SIG_MISMATCH  3
+#define ED25519_POINT_INVALID 4
+
+void ed25519_key(void *sk, void *pk);
+void ed25519_seed_key(const void *seed, void *sk, void *pk);
+void ed25519_sign(const void *msg, size_t len, const void *sk, void *sig);
+int ed25519_verify(const void *msg, size_t len, const void *pk, const void *sig);
+int ed25519_verify_batch(const void *msgs[], const size_t lens[], const void *pks[], const void *sigs[], int count, int results[]);
+
+#endif
@@ -0,0 +1,496 @@
+/*
+ * Copyright(c) 2020-2023 All rights reserved by Heekuck Oh.
+ * 이 프로그램은 한양대학교 ERICA 컴퓨터학부 학생을 위한 교육용으로 제작되었다.
+ * 한양대학교 ERICA 학생이 아닌 자는 이 프로그램을 수정하거나 배포할 수 없다.
+ * 프로그램을 수정할 경우 날짜, 학과, 학번, 이름, 수정 내용을 기록한다.
+ */
+#include <string.h>
+#include "k256.h"
+
+typedef unsigned __int128 u128;
+
+#define L K256_LIMBS
+
+// p = 2^256 - 2^32 - 977이고, 2^256 = C (mod p)이다
+static const uint64_t P[L] = {
+    0xfffffffefffffc2fULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL
+};
+static const uint64_t C = 0x1000003d1ULL;
+
+// n = FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364141
+static const uint64_t N[L] = {
+    0xbfd25e8cd0364141ULL, 0xbaaedce6af48a03bULL, 0xfffffffffffffffeULL, 0xffffffffffffffffULL
+};
+
+// 몽고메리 곱셈에 사용하는 -n^-1 mod 2^64와 R^2 mod n (R = 2^256)
+static const uint64_t N0 = 0x4b0dff665588b13fULL;
+static const uint64_t RR_N[L] = {
+    0x896cf21467d7d140ULL, 0x741496c20e7cf878ULL, 0xe697f5e45bcd07c6ULL, 0x9d671cd581c69bc5ULL
+};
+
+/*
+ * 스칼라 분해에 쓰는 상수. lambda는 x^2 + x + 1 = 0 (mod n)의 근이고, (b1, b2)는 격자
+ * {(a, b) : a + b*lambda = 0 (mod n)}의 짧은 기저에서 얻은 값이다. g1 = round(2^384 * b2 / n),
+ * g2 = round(2^384 * -b1 / n)이며, MB1 = -b1, MB2 = -b2 mod n이다.
+ */
+static const uint64_t LAMBDA[L] = {
+    0xdf02967c1b23bd72ULL, 0x122e22ea20816678ULL, 0xa5261c028812645aULL, 0x5363ad4cc05c30e0ULL
+};
+static const uint64_t G1[L] = {
+    0xe893209a45dbb031ULL, 0x3daa8a1471e8ca7fULL, 0xe86c90e49284eb15ULL, 0x3086d221a7d46bcdULL
+};
+static const uint64_t G2[L] = {
+    0x1571b4ae8ac47f71ULL, 0x221208ac9df506c6ULL, 0x6f547fa90abfe4c4ULL, 0xe4437ed6010e8828ULL
+};
+static const uint64_t MB1[L] = {
+    0x6f547fa90abfe4c3ULL, 0xe4437ed6010e8828ULL, 0x0000000000000000ULL, 0x0000000000000000ULL
+};
+static const uint64_t MB2[L] = {
+    0xd765cda83db1562cULL, 0x8a280ac50774346dULL, 0xfffffffffffffffeULL, 0xffffffffffffffffULL
+};
+// (n - 1) / 2
+static const uint64_t N_HALF[L] = {
+    0xdfe92f46681b20a0ULL, 0x5d576e7357a4501dULL, 0xffffffffffffffffULL, 0x7fffffffffffffffULL
+};
+
+/*
+ * 림 단위 보조 함수
+ */
+
+// r = a + b, 올림수를 반환한다
+static uint64_t add4(uint64_t r[L], const uint64_t a[L], const uint64_t b[L])
+{
+    u128 acc = 0;
+    int i;
+    for (i = 0; i < L; i++) {
+        acc += (u128)a[i] + b[i];
+        r[i] = (uint64_t)acc;
+        acc >>= 64;
+    }
+    return (uint64_t)acc;
+}
+
+// r = a - b, 빌림수를 반환한다
+static uint64_t sub4(uint64_t r[L], const uint64_t a[L], const uint64_t b[L])
+{
+    uint64_t borrow = 0, t, u;
+    int i;
+    for (i = 0; i < L; i++) {
+        t = a[i] - b[i];
+        u = (a[i] < b[i]) | (t < borrow);
+        r[i] = t - borrow;
+        borrow = u;
+    }
+    return borrow;
+}
+
+// mask가 모두 1이면 r = b, 0이면 r = a로 분기 없이 선택한다
+static void sel4(uint64_t r[L], const uint64_t a[L], const uint64_t b[L], uint64_t mask)
+{
+    int i;
+    for (i = 0; i < L; i++)
+        r[i] = a[i] ^ (mask & (a[i] ^ b[i]));
+}
+
+// t = a * b (512비트)
+static void mul4(uint64_t t[2*L], const uint64_t a[L], const uint64_t b[L])
+{
+    u128 acc;
+    uint64_t carry;
+    int i, j;
+
+    memset(t, 0, 2 * L * sizeof(uint64_t));
+    for (i = 0; i < L; i++) {
+        carry = 0;
+        for (j = 0; j < L; j++) {
+            acc = (u128)a[i] * b[j] + t[i+j] + carry;
+            t[i+j] = (uint64_t)acc;
+            carry = (uint64_t)(acc >> 64);
+        }
+        t[i+L] = carry;
+    }
+}
+
+// t = a^2 (512비트). 교차항은 한 번만 곱한 뒤 두 배로 만든다
+static void sqr4(uint64_t t[2*L], const uint64_t a[L])
+{
+    u128 acc;
+    uint64_t carry;
+    int i, j;
+
+    memset(t, 0, 2 * L * sizeof(uint64_t));
+    for (i = 0; i < L - 1; i++) {
+        carry = 0;
+        for (j = i + 1; j < L; j++) {
+            acc = (u128)a[i] * a[j] + t[i+j] + carry;
+            t[i+j] = (uint64_t)acc;
+            carry = (uint64_t)(acc >> 64);
+        }
+        t[i+L] = carry;
+    }
+    t[2*L-1] = t[2*L-2] >> 63;
+    for (i = 2*L - 2; i > 0; i--)
+        t[i] = (t[i] << 1) | (t[i-1] >> 63);
+    t[0] <<= 1;
+    carry = 0;
+    for (i = 0; i < L; i++) {
+        acc = (u128)a[i] * a[i] + t[2*i] + carry;
+        t[2*i] = (uint64_t)acc;
+        acc = (acc >> 64) + t[2*i+1];
+        t[2*i+1] = (uint64_t)acc;
+        carry = (uint64_t)(acc >> 64);
+    }
+}
+
+/*
+ * k256_reduce() - 512비트 t = lo + hi*2^256을 mod p로 축약한다.
+ * 2^256 = C = 2^32 + 977 (mod p)이므로 lo + hi*C를 계산하면 2^290보다 작은 값이 되고,
+ * 넘친 부분 c를 c*C로 한 번 더 접은 뒤 p를 한 번 빼서 [0, p)로 맞춘다.
+ */
+static void k256_reduce(k256_fe r, const uint64_t t[2*L])
+{
+    uint64_t v[L], u[L], top, borrow;
+    u128 acc = 0;
+    int i;
+
+    for (i = 0; i < L; i++) {
+        acc += (u128)t[i+L] * C + t[i];
+        v[i] = (uint64_t)acc;
+        acc >>= 64;
+    }
+    top = (uint64_t)acc;                // top < 2^34
+    acc = (u128)top * C;
+    for (i = 0; i < L; i++) {
+        acc += v[i];
+        v[i] = (uint64_t)acc;
+        acc >>= 64;
+    }
+    // 다시 넘쳤다면 v는 2^67보다 작으므로 C를 더해도 넘치지 않는다
+    acc = (u128)((uint64_t)acc * C) + v[0];
+    v[0] = (uint64_t)acc;
+    acc = (acc >> 64) + v[1];
+    v[1] = (uint64_t)acc;
+    acc = (acc >> 64) + v[2];
+    v[2] = (uint64_t)acc;
+    v[3] += (uint64_t)(acc >> 64);
+
+    borrow = sub4(u, v, P);
+    sel4(r, v, u, borrow - 1);
+}
+
+/*
+ * 유한체 GF(p) 연산
+ */
+
+void k256_fe_set_ui(k256_fe r, uint64_t a)
+{
+    r[0] = a;
+    r[1] = r[2] = r[3] = 0;
+}
+
+void k256_fe_copy(k256_fe r, const k256_fe a)
+{
+    memcpy(r, a, sizeof(k256_fe));
+}
+
+void k256_fe_cmov(k256_fe r, const k256_fe a, int flag)
+{
+    sel4(r, r, a, -(uint64_t)(flag != 0));
+}
+
+// 빅 엔디안 32바이트를 읽는다. 값이 p 이상이면 mod p로 축약하고 0을 반환한다
+int k256_fe_from_bytes(k256_fe r, const unsigned char *in)
+{
+    uint64_t t[L];
+    int i, j;
+
+    for (i = 0; i < L; i++) {
+        r[i] = 0;
+        for (j = 0; j < 8; j++)
+            r[i] = (r[i] << 8) | in[(L-1-i)*8 + j];
+    }
+    if (sub4(t, r, P))
+        return 1;
+    memcpy(r, t, sizeof(t));
+    return 0;
+}
+
+void k256_fe_to_bytes(unsigned char *out, const k256_fe a)
+{
+    int i, j;
+    for (i = 0; i < L; i++)
+        for (j = 0; j < 8; j++)
+            out[(L-1-i)*8 + j] = (unsigned char)(a[i] >> (56 - 8*j));
+}
+
+int k256_fe_is_zero(const k256_fe a)
+{
+    return (a[0] | a[1] | a[2] | a[3]) == 0;
+}
+
+int k256_fe_equal(const k256_fe a, const k256_fe b)
+{
+    return ((a[0] ^ b[0]) | (a[1] ^ b[1]) | (a[2] ^ b[2]) | (a[3] ^ b[3])) == 0;
+}
+
+void k256_fe_add(k256_fe r, const k256_fe a, const k256_fe b)
+{
+    uint64_t s[L], t[L], carry, borrow;
+
+    carry = add4(s, a, b);
+    borrow = sub4(t, s, P);
+    sel4(r, s, t, -(carry | (borrow ^ 1)));
+}
+
+void k256_fe_sub(k256_fe r, const k256_fe a, const k256_fe b)
+{
+    uint64_t d[L], t[L], borrow;
+
+    borrow = sub4(d, a, b);
+    add4(t, d, P);
+    sel4(r, d, t, -borrow);
+}
+
+void k256_fe_neg(k256_fe r, const k256_fe a)
+{
+    static const k256_fe zero = {0, 0, 0, 0};
+    k256_fe_sub(r, zero, a);
+}
+
+void k256_fe_mul(k256_fe r, const k256_fe a, const k256_fe b)
+{
+    uint64_t t[2*L];
+    mul4(t, a, b);
+    k256_reduce(r, t);
+}
+
+void k256_fe_sqr(k256_fe r, const k256_fe a)
+{
+    uint64_t t[2*L];
+    sqr4(t, a);
+    k256_reduce(r, t);
+}
+
+// r = a^(2^k)
+static void k256_fe_sqr_n(k256_fe r, const k256_fe a, int k)
+{
+    k256_fe_sqr(r, a);
+    while (--k > 0)
+        k256_fe_sqr(r, r);
+}
+
+/*
+ * k256_fe_inv() - 페르마 정리로 r = a^(p-2)를 계산한다.
+ * p - 2는 위에서부터 1이 223개, 0, 1이 22개, 0000101101이다.
+ * 제곱 255번과 곱셈 15번의 고정된 사슬로 계산한다.
+ */
+void k256_fe_inv(k256_fe r, const k256_fe a)
+{
+    k256_fe x2, x3, x6, x9, x11, x22, x44, x88, x176, x220, x223, t;
+
+    k256_fe_sqr(x2, a);
+    k256_fe_mul(x2, x2, a);             // 2^2 - 1
+    k256_fe_sqr(x3, x2);
+    k256_fe_mul(x3, x3, a);             // 2^3 - 1
+    k256_fe_sqr_n(x6, x3, 3);
+    k256_fe_mul(x6, x6, x3);            // 2^6 - 1
+    k256_fe_sqr_n(x9, x6, 3);
+    k256_fe_mul(x9, x9, x3);            // 2^9 - 1
+    k256_fe_sqr_n(x11, x9, 2);
+    k256_fe_mul(x11, x11, x2);          // 2^11 - 1
+    k256_fe_sqr_n(x22, x11, 11);
+    k256_fe_mul(x22, x22, x11);         // 2^22 - 1
+    k256_fe_sqr_n(x44, x22, 22);
+    k256_fe_mul(x44, x44, x22);         // 2^44 - 1
+    k256_fe_sqr_n(x88, x44, 44);
+    k256_fe_mul(x88, x88, x44);         // 2^88 - 1
+    k256_fe_sqr_n(x176, x88, 88);
+    k256_fe_mul(x176, x176, x88);       // 2^176 - 1
+    k256_fe_sqr_n(x220, x176, 44);
+    k256_fe_mul(x220, x220, x44);       // 2^220 - 1
+    k256_fe_sqr_n(x223, x220, 3);
+    k256_fe_mul(x223, x223, x3);        // 2^223 - 1
+
+    k256_fe_sqr_n(t, x223, 23);
+    k256_fe_mul(t, t, x22);             // ... 0 + 1이 22개
+    k256_fe_sqr_n(t, t, 5);
+    k256_fe_mul(t, t, a);               // ... 00001
+    k256_fe_sqr_n(t, t, 3);
+    k256_fe_mul(t, t, x2);              // ... 011
+    k256_fe_sqr_n(t, t, 2);
+    k256_fe_mul(r, t, a);               // ... 01
+}
+
+/*
+ * 위수 n에 대한 스칼라 연산
+ */
+
+// 몽고메리 곱셈 r = a*b*R^-1 mod n (CIOS 방식)
+static void k256_sc_montmul(uint64_t r[L], const uint64_t a[L], const uint64_t b[L])
+{
+    uint64_t t[L+2], carry, m, u[L], borrow;
+    u128 acc;
+    int i, j;
+
+    memset(t, 0, sizeof(t));
+    for (i = 0; i < L; i++) {
+        // t = t + a[i]*b
+        carry = 0;
+        for (j = 0; j < L; j++) {
+            acc = (u128)a[i] * b[j] + t[j] + carry;
+            t[j] = (uint64_t)acc;
+            carry = (uint64_t)(acc >> 64);
+        }
+        acc = (u128)t[L] + carry;
+        t[L] = (uint64_t)acc;
+        t[L+1] = (uint64_t)(acc >> 64);
+        // t = (t + m*n) / 2^64
+        m = t[0] * N0;
+        acc = (u128)m * N[0] + t[0];
+        carry = (uint64_t)(acc >> 64);
+        for (j = 1; j < L; j++) {
+            acc = (u128)m * N[j] + t[j] + carry;
+            t[j-1] = (uint64_t)acc;
+            carry = (uint64_t)(acc >> 64);
+        }
+        acc = (u128)t[L] + carry;
+        t[L-1] = (uint64_t)acc;
+        t[L] = t[L+1] + (uint64_t)(acc >> 64);
+    }
+    // t < 2n이므로 한 번만 빼면 된다
+    borrow = sub4(u, t, N);
+    sel4(r, t, u, -(t[L] | (borrow ^ 1)));
+}
+
+// 빅 엔디안 32바이트를 읽어 mod n으로 축약한다. 원래 값이 n보다 작았으면 1을 반환한다
+int k256_sc_from_bytes(k256_sc r, const unsigned char *in)
+{
+    uint64_t t[L];
+    int i, j;
+
+    for (i = 0; i < L; i++) {
+        r[i] = 0;
+        for (j = 0; j < 8; j++)
+            r[i] = (r[i] << 8) | in[(L-1-i)*8 + j];
+    }
+    // 2^256 < 2n이므로 n을 한 번만 빼면 된다
+    if (sub4(t, r, N))
+        return 1;
+    memcpy(r, t, sizeof(t));
+    return 0;
+}
+
+void k256_sc_to_bytes(unsigned char *out, const k256_sc a)
+{
+    k256_fe_to_bytes(out, a);
+}
+
+int k256_sc_is_zero(const k256_sc a)
+{
+    return k256_fe_is_zero(a);
+}
+
+int k256_sc_equal(const k256_sc a, const k256_sc b)
+{
+    return k256_fe_equal(a, b);
+}
+
+void k256_sc_add(k256_sc r, const k256_sc a, const k256_sc b)
+{
+    uint64_t s[L], t[L], carry, borrow;
+
+    carry = add4(s, a, b);
+    borrow = sub4(t, s, N);
+    sel4(r, s, t, -(carry | (borrow ^ 1)));
+}
+
+void k256_sc_neg(k256_sc r, const k256_sc a)
+{
+    static const k256_sc zero = {0, 0, 0, 0};
+    uint64_t t[L];
+
+    sub4(t, N, a);
+    sel4(r, t, zero, -(uint64_t)k256_sc_is_zero(a));
+}
+
+// r = a*b mod n. 몽고메리 곱셈 결과에 R^2를 한 번 더 곱해 R^-1을 없앤다
+void k256_sc_mul(k256_sc r, const k256_sc a, const k256_sc b)
+{
+    uint64_t t[L];
+    k256_sc_montmul(t, a, b);
+    k256_sc_montmul(r, t, RR_N);
+}
+
+/*
+ * k256_sc_inv() - 페르마 정리로 r = a^(n-2) mod n을 p256_sc_inv()와 같은 4비트 고정 윈도우로 계산한다.
+ */
+void k256_sc_inv(k256_sc r, const k256_sc a)
+{
+    static const uint64_t E[L] = {
+        0xbfd25e8cd036413fULL, 0xbaaedce6af48a03bULL, 0xfffffffffffffffeULL, 0xffffffffffffffffULL
+    };
+    static const uint64_t one[L] = {1, 0, 0, 0};
+    uint64_t tbl[16][L], x[L];
+    int i, j, w;
+
+    // tbl[i] = a^i (몽고메리 형태), tbl[0] = R mod n
+    k256_sc_montmul(tbl[1], a, RR_N);
+    k256_sc_montmul(tbl[0], one, RR_N);
+    for (i = 2; i < 16; i++)
+        k256_sc_montmul(tbl[i], tbl[i-1], tbl[1]);
+
+    memcpy(x, tbl[0], sizeof(x));
+    for (i = 16*L - 1; i >= 0; i--) {
+        for (j = 0; j < 4; j++)
+            k256_sc_montmul(x, x, x);
+        w = (int)(E[i/16] >> (4 * (i % 16))) & 0xf;
+        k256_sc_montmul(x, x, tbl[w]);
+    }
+    k256_sc_montmul(r, x, one);
+}
+
+// r = round(k*g / 2^384). k*g의 2^383 자리를 더한 뒤 위의 128비트를 취한다
+static void k256_mul_shift384(k256_sc r, const k256_sc k, const uint64_t g[L])
+{
+    uint64_t t[2*L];
+    u128 acc;
+
+    mul4(t, k, g);
+    acc = (u128)t[6] + (t[5] >> 63);
+    r[0] = (uint64_t)acc;
+    r[1] = t[7] + (uint64_t)(acc >> 64);
+    r[2] = r[3] = 0;
+}
+
+// a가 (n-1)/2보다 크면 a = n - a로 바꾸고 1을, 그렇지 않으면 0을 반환한다
+static int k256_sc_abs(k256_sc a)
+{
+    uint64_t t[L], big;
+
+    big = sub4(t, N_HALF, a);
+    k256_sc_neg(t, a);
+    sel4(a, a, t, -big);
+    return (int)big;
+}
+
+/*
+ * k256_sc_split() - k = k1 + k2*lambda (mod n)를 격자 기저 반올림으로 구한다.
+ * c1 = round(k*b2/n), c2 = round(-k*b1/n)을 g1, g2와의 곱으로 근사한 뒤
+ * k2 = c1*(-b1) + c2*(-b2), k1 = k - k2*lambda로 두면 둘 다 절댓값이 2^128보다 작다.
+ * 분기 없이 계산하므로 서명의 k에 써도 된다.
+ */
+void k256_sc_split(k256_sc k1, k256_sc k2, int *neg1, int *neg2, const k256_sc k)
+{
+    uint64_t c1[L], c2[L], t[L];
+
+    k256_mul_shift384(c1, k, G1);
+    k256_mul_shift384(c2, k, G2);
+    k256_sc_mul(c1, c1, MB1);
+    k256_sc_mul(c2, c2, MB2);
+    k256_sc_add(k2, c1, c2);
+    k256_sc_mul(t, k2, LAMBDA);
+    k256_sc_neg(t, t);
+    k256_sc_add(k1, k, t);
+    *neg1 = k256_sc_abs(k1);
+    *neg2 = k256_sc_abs(k2);
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright(c) 2020-2023 All rights reserved by Heekuck Oh.
+ * 이 프로그램은 한양대학교 ERICA 컴퓨터학부 학생을 위한 교육용으로 제작되었다.
+ * 한양대학교 ERICA 학생이 아닌 자는 이 프로그램을 수정하거나 배포할 수 없다.
+ * 프로그램을 수정할 경우 날짜, 학과, 학번, 이름, 수정 내용을 기록한다.
+ */
+#ifndef _K256_H_
+#define _K256_H_
+#include <stdint.h>
+
+#define K256_LIMBS 4
+
+/*
+ * secp256k1 유한체 GF(p)의 원소로, p = 2^256 - 2^32 - 977이다.
+ * 64비트 림 4개를 리틀 엔디안 순서로 저장하며, p256_fe와 같이 [0, p) 범위의 값만 주고받는다.
+ */
+typedef uint64_t k256_fe[K256_LIMBS];
+
+// 위수 n에 대한 스칼라로 [0, n) 범위의 일반 정수를 저장한다
+typedef uint64_t k256_sc[K256_LIMBS];
+
+void k256_fe_set_ui(k256_fe r, uint64_t a);
+void k256_fe_copy(k256_fe r, const k256_fe a);
+void k256_fe_cmov(k256_fe r, const k256_fe a, int flag);
+int k256_fe_from_bytes(k256_fe r, const unsigned char *in);
+void k256_fe_to_bytes(unsigned char *out, const k256_fe a);
+int k256_fe_is_zero(const k256_fe a);
+int k256_fe_equal(const k256_fe a, const k256_fe b);
+void k256_fe_add(k256_fe r, const k256_fe a, const k256_fe b);
+void k256_fe_sub(k256_fe r, const k256_fe a, const k256_fe b);
+void k256_fe_neg(k256_fe r, const k256_fe a);
+void k256_fe_mul(k256_fe r, const k256_fe a, const k256_fe b);
+void k256_fe_sqr(k256_fe r, const k256_fe a);
+void k256_fe_inv(k256_fe r, const k256_fe a);
+
+int k256_sc_from_bytes(k256_sc r, const unsigned char *in);
+void k256_sc_to_bytes(unsigned char *out, const k256_sc a);
+int k256_sc_is_zero(const k256_sc a);
+int k256_sc_equal(const k256_sc a, const k256_sc b);
+void k256_sc_add(k256_sc r, const k256_sc a, const k256_sc b);
+void k256_sc_neg(k256_sc r, const k256_sc a);
+void k256_sc_mul(k256_sc r, const k256_sc a, const k256_sc b);
+void k256_sc_inv(k256_sc r, const k256_sc a);
+
+/*
+ * 자기 준동형 사상 phi(x, y) = (beta*x, y) = lambda*(x, y)를 이용해 k = k1 + k2*lambda (mod n)로
+ * 나눈다. |k1|, |k2| < 2^128이며 k1, k2에는 절댓값을, neg1, neg2에는 부호를 넘겨준다.
+ */
+void k256_sc_split(k256_sc k1, k256_sc k2, int *neg1, int *neg2, const k256_sc k);
+
+#endif
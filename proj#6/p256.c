@@ -0,0 +1,487 @@
+/*
+ * Copyright(c) 2020-2023 All rights reserved by Heekuck Oh.
+ * 이 프로그램은 한양대학교 ERICA 컴퓨터학부 학생을 위한 교육용으로 제작되었다.
+ * 한양대학교 ERICA 학생이 아닌 자는 이 프로그램을 수정하거나 배포할 수 없다.
+ * 프로그램을 수정할 경우 날짜, 학과, 학번, 이름, 수정 내용을 기록한다.
+ */
+#include <string.h>
+#include "p256.h"
+
+typedef unsigned __int128 u128;
+
+// p = 2^256 - 2^224 + 2^192 + 2^96 - 1
+static const uint64_t P[4] = {
+    0xffffffffffffffffULL, 0x00000000ffffffffULL, 0x0000000000000000ULL, 0xffffffff00000001ULL
+};
+
+// n = FFFFFFFF00000000FFFFFFFFFFFFFFFFBCE6FAADA7179E84F3B9CAC2FC632551
+static const uint64_t N[4] = {
+    0xf3b9cac2fc632551ULL, 0xbce6faada7179e84ULL, 0xffffffffffffffffULL, 0xffffffff00000000ULL
+};
+
+// 몽고메리 곱셈에 사용하는 -n^-1 mod 2^64와 R^2 mod n (R = 2^256)
+static const uint64_t N0 = 0xccd1c8aaee00bc4fULL;
+static const uint64_t RR_N[4] = {
+    0x83244c95be79eea2ULL, 0x4699799c49bd6fa6ULL, 0x2845b2392b6bec59ULL, 0x66e12d94f3d95620ULL
+};
+
+/*
+ * 림 단위 보조 함수
+ */
+
+// r = a + b, 올림수를 반환한다
+static uint64_t add4(uint64_t r[4], const uint64_t a[4], const uint64_t b[4])
+{
+    u128 acc = 0;
+    int i;
+    for (i = 0; i < 4; i++) {
+        acc += (u128)a[i] + b[i];
+        r[i] = (uint64_t)acc;
+        acc >>= 64;
+    }
+    return (uint64_t)acc;
+}
+
+// r = a - b, 빌림수를 반환한다
+static uint64_t sub4(uint64_t r[4], const uint64_t a[4], const uint64_t b[4])
+{
+    uint64_t borrow = 0, t, u;
+    int i;
+    for (i = 0; i < 4; i++) {
+        t = a[i] - b[i];
+        u = (a[i] < b[i]) | (t < borrow);
+        r[i] = t - borrow;
+        borrow = u;
+    }
+    return borrow;
+}
+
+// mask가 모두 1이면 r = b, 0이면 r = a로 분기 없이 선택한다
+static void sel4(uint64_t r[4], const uint64_t a[4], const uint64_t b[4], uint64_t mask)
+{
+    r[0] = a[0] ^ (mask & (a[0] ^ b[0]));
+    r[1] = a[1] ^ (mask & (a[1] ^ b[1]));
+    r[2] = a[2] ^ (mask & (a[2] ^ b[2]));
+    r[3] = a[3] ^ (mask & (a[3] ^ b[3]));
+}
+
+// t = a * b (512비트)
+static void mul4(uint64_t t[8], const uint64_t a[4], const uint64_t b[4])
+{
+    u128 acc;
+    uint64_t carry;
+    int i, j;
+
+    memset(t, 0, 8 * sizeof(uint64_t));
+    for (i = 0; i < 4; i++) {
+        carry = 0;
+        for (j = 0; j < 4; j++) {
+            acc = (u128)a[i] * b[j] + t[i+j] + carry;
+            t[i+j] = (uint64_t)acc;
+            carry = (uint64_t)(acc >> 64);
+        }
+        t[i+4] = carry;
+    }
+}
+
+// t = a^2 (512비트). 교차항은 한 번만 곱한 뒤 두 배로 만든다
+static void sqr4(uint64_t t[8], const uint64_t a[4])
+{
+    u128 acc;
+    uint64_t carry;
+    int i, j;
+
+    memset(t, 0, 8 * sizeof(uint64_t));
+    for (i = 0; i < 3; i++) {
+        carry = 0;
+        for (j = i + 1; j < 4; j++) {
+            acc = (u128)a[i] * a[j] + t[i+j] + carry;
+            t[i+j] = (uint64_t)acc;
+            carry = (uint64_t)(acc >> 64);
+        }
+        t[i+4] = carry;
+    }
+    t[7] = t[6] >> 63;
+    for (i = 6; i > 0; i--)
+        t[i] = (t[i] << 1) | (t[i-1] >> 63);
+    t[0] <<= 1;
+    carry = 0;
+    for (i = 0; i < 4; i++) {
+        acc = (u128)a[i] * a[i] + t[2*i] + carry;
+        t[2*i] = (uint64_t)acc;
+        acc = (acc >> 64) + t[2*i+1];
+        t[2*i+1] = (uint64_t)acc;
+        carry = (uint64_t)(acc >> 64);
+    }
+}
+
+/*
+ * p256_reduce() - 512비트 t를 mod p로 축약한다.
+ * FIPS 186-4 D.2.3의 빠른 축약 r = s1 + 2s2 + 2s3 + s4 + s5 - s6 - s7 - s8 - s9 (mod p)를
+ * 사용한다. 32비트 워드 c0..c15로 정의된 s1..s9를 64비트 림으로 묶어 림마다 부호 있는
+ * 128비트로 누적한 뒤 올림을 한 번 전파한다. 남은 작은 올림 c는
+ * 2^256 = 2^224 - 2^192 - 2^96 + 1 (mod p)을 이용해 한 번 더 접는다.
+ */
+static void p256_reduce(p256_fe r, const uint64_t t[8])
+{
+    const uint64_t LO = 0x00000000ffffffffULL, HI = 0xffffffff00000000ULL;
+    const uint64_t t4 = t[4], t5 = t[5], t6 = t[6], t7 = t[7];
+    __int128 a0, a1, a2, a3;
+    int64_t carry;
+    uint64_t v[4], vm[4], vp[4], borrow, m_pos, m_neg, m_zero;
+
+    /*
+     * t4 = c9:c8, t5 = c11:c10, t6 = c13:c12, t7 = c15:c14로 읽으면 각 s의 림은 다음과 같다.
+     *   s2 = (c15,c14,c13,c12,c11,0,0,0)      s3 = (0,c15,c14,c13,c12,0,0,0)
+     *   s4 = (c15,c14,0,0,0,c10,c9,c8)        s5 = (c8,c13,c15,c14,c13,c11,c10,c9)
+     *   s6 = (c10,c8,0,0,0,c13,c12,c11)       s7 = (c11,c9,0,0,c15,c14,c13,c12)
+     *   s8 = (c12,0,c10,c9,c8,c15,c14,c13)    s9 = (c13,0,c11,c10,c9,0,c15,c14)
+     * 더하는 항과 빼는 항을 따로 부호 없는 128비트로 모은 뒤 마지막에 한 번 뺀다.
+     */
+    const uint64_t c12_11 = (t5 >> 32) | (t6 << 32);
+    const uint64_t c14_13 = (t6 >> 32) | (t7 << 32);
+    const uint64_t c10_9 = (t4 >> 32) | (t5 << 32);
+    u128 p0, p1, p2, p3, n0, n1, n2, n3;
+
+    p0 = (u128)t[0] + t4 + c10_9;
+    n0 = (u128)c12_11 + t6 + c14_13 + t7;
+    p1 = (u128)t[1] + ((u128)(t5 & HI) << 1) + ((u128)(t6 << 32) << 1) + (t5 & LO) + ((t5 >> 32) | (t6 & HI));
+    n1 = (u128)(t6 >> 32) + t7 + ((t7 >> 32) | (t4 << 32)) + (t4 & HI);
+    p2 = (u128)t[2] + ((u128)t6 << 1) + ((u128)c14_13 << 1) + t7;
+    n2 = (u128)c10_9 + t5;
+    p3 = (u128)t[3] + ((u128)t7 << 1) + ((u128)(t7 >> 32) << 1) + t7 + ((t6 >> 32) | (t4 << 32));
+    n3 = (u128)((t4 & LO) | (t5 << 32)) + ((t4 >> 32) | (t5 & HI)) + (t6 << 32) + (t6 & HI);
+    a0 = (__int128)p0 - (__int128)n0;
+    a1 = (__int128)p1 - (__int128)n1;
+    a2 = (__int128)p2 - (__int128)n2;
+    a3 = (__int128)p3 - (__int128)n3;
+
+    a1 += a0 >> 64;
+    a2 += a1 >> 64;
+    a3 += a2 >> 64;
+    carry = (int64_t)(a3 >> 64);
+    // c*2^256 = c*(2^224 - 2^192 - 2^96 + 1)
+    a0 = (__int128)(uint64_t)a0 + carry;
+    a1 = (__int128)(uint64_t)a1 - ((__int128)carry << 32);
+    a2 = (__int128)(uint64_t)a2;
+    a3 = (__int128)(uint64_t)a3 - carry + ((__int128)carry << 32);
+    a1 += a0 >> 64;
+    a2 += a1 >> 64;
+    a3 += a2 >> 64;
+    carry = (int64_t)(a3 >> 64);
+    v[0] = (uint64_t)a0;
+    v[1] = (uint64_t)a1;
+    v[2] = (uint64_t)a2;
+    v[3] = (uint64_t)a3;
+
+    /*
+     * 이제 값은 v + carry*2^256이고 carry는 -1, 0, 1 중 하나이다.
+     * carry = 1이면 v - p, carry = -1이면 v + p, carry = 0이면 v >= p일 때 v - p가 답이다.
+     */
+    borrow = sub4(vm, v, P);
+    add4(vp, v, P);
+    m_pos = -(uint64_t)(carry == 1);
+    m_neg = -(uint64_t)(carry == -1);
+    m_zero = -(uint64_t)(carry == 0);
+    sel4(v, v, vm, m_pos | (m_zero & (borrow - 1)));
+    sel4(r, v, vp, m_neg);
+}
+
+/*
+ * 유한체 GF(p) 연산
+ */
+
+void p256_fe_set_ui(p256_fe r, uint64_t a)
+{
+    r[0] = a;
+    r[1] = r[2] = r[3] = 0;
+}
+
+void p256_fe_copy(p256_fe r, const p256_fe a)
+{
+    memcpy(r, a, sizeof(p256_fe));
+}
+
+// flag가 1이면 r = a, 0이면 r을 그대로 둔다. 비밀 색인으로 표를 읽을 때 분기 없이 쓴다
+void p256_fe_cmov(p256_fe r, const p256_fe a, int flag)
+{
+    sel4(r, r, a, -(uint64_t)(flag != 0));
+}
+
+// 빅 엔디안 32바이트를 읽는다. 값이 p 이상이면 mod p로 축약하고 0을 반환한다
+int p256_fe_from_bytes(p256_fe r, const unsigned char *in)
+{
+    uint64_t t[4];
+    int i, j;
+
+    for (i = 0; i < 4; i++) {
+        r[i] = 0;
+        for (j = 0; j < 8; j++)
+            r[i] = (r[i] << 8) | in[(3-i)*8 + j];
+    }
+    if (sub4(t, r, P))
+        return 1;
+    memcpy(r, t, sizeof(t));
+    return 0;
+}
+
+void p256_fe_to_bytes(unsigned char *out, const p256_fe a)
+{
+    int i, j;
+    for (i = 0; i < 4; i++)
+        for (j = 0; j < 8; j++)
+            out[(3-i)*8 + j] = (unsigned char)(a[i] >> (56 - 8*j));
+}
+
+int p256_fe_is_zero(const p256_fe a)
+{
+    return (a[0] | a[1] | a[2] | a[3]) == 0;
+}
+
+int p256_fe_equal(const p256_fe a, const p256_fe b)
+{
+    return ((a[0] ^ b[0]) | (a[1] ^ b[1]) | (a[2] ^ b[2]) | (a[3] ^ b[3])) == 0;
+}
+
+void p256_fe_add(p256_fe r, const p256_fe a, const p256_fe b)
+{
+    uint64_t s[4], t[4], carry, borrow;
+
+    carry = add4(s, a, b);
+    borrow = sub4(t, s, P);
+    // a + b >= 2^256 이거나 a + b >= p이면 p를 뺀 값을 선택한다
+    sel4(r, s, t, -(carry | (borrow ^ 1)));
+}
+
+void p256_fe_sub(p256_fe r, const p256_fe a, const p256_fe b)
+{
+    uint64_t d[4], t[4], borrow;
+
+    borrow = sub4(d, a, b);
+    add4(t, d, P);
+    sel4(r, d, t, -borrow);
+}
+
+void p256_fe_neg(p256_fe r, const p256_fe a)
+{
+    static const p256_fe zero = {0, 0, 0, 0};
+    p256_fe_sub(r, zero, a);
+}
+
+void p256_fe_mul(p256_fe r, const p256_fe a, const p256_fe b)
+{
+    uint64_t t[8];
+    mul4(t, a, b);
+    p256_reduce(r, t);
+}
+
+void p256_fe_sqr(p256_fe r, const p256_fe a)
+{
+    uint64_t t[8];
+    sqr4(t, a);
+    p256_reduce(r, t);
+}
+
+// r = a^(2^k)
+static void p256_fe_sqr_n(p256_fe r, const p256_fe a, int k)
+{
+    p256_fe_sqr(r, a);
+    while (--k > 0)
+        p256_fe_sqr(r, r);
+}
+
+/*
+ * p256_fe_inv() - 페르마 정리로 r = a^(p-2)를 계산한다.
+ * p - 2 = FFFFFFFF 00000001 00000000 00000000 00000000 FFFFFFFF FFFFFFFF FFFFFFFD
+ * x_k = a^(2^k - 1)을 만든 뒤 고정된 덧셈 사슬로 지수를 위에서부터 채운다.
+ * 제곱 255번과 곱셈 12번이 들어가며 입력 값에 관계없이 연산 순서가 같다. a = 0이면 0이 된다.
+ */
+void p256_fe_inv(p256_fe r, const p256_fe a)
+{
+    p256_fe x2, x3, x6, x12, x15, x30, x32, t;
+
+    p256_fe_sqr(x2, a);
+    p256_fe_mul(x2, x2, a);             // 2^2 - 1
+    p256_fe_sqr(x3, x2);
+    p256_fe_mul(x3, x3, a);             // 2^3 - 1
+    p256_fe_sqr_n(x6, x3, 3);
+    p256_fe_mul(x6, x6, x3);            // 2^6 - 1
+    p256_fe_sqr_n(x12, x6, 6);
+    p256_fe_mul(x12, x12, x6);          // 2^12 - 1
+    p256_fe_sqr_n(x15, x12, 3);
+    p256_fe_mul(x15, x15, x3);          // 2^15 - 1
+    p256_fe_sqr_n(x30, x15, 15);
+    p256_fe_mul(x30, x30, x15);         // 2^30 - 1
+    p256_fe_sqr_n(x32, x30, 2);
+    p256_fe_mul(x32, x32, x2);          // 2^32 - 1
+
+    p256_fe_sqr_n(t, x32, 32);
+    p256_fe_mul(t, t, a);               // FFFFFFFF 00000001
+    p256_fe_sqr_n(t, t, 128);
+    p256_fe_mul(t, t, x32);             // ... 00000000 00000000 00000000 FFFFFFFF
+    p256_fe_sqr_n(t, t, 32);
+    p256_fe_mul(t, t, x32);             // ... FFFFFFFF
+    p256_fe_sqr_n(t, t, 30);
+    p256_fe_mul(t, t, x30);             // ... 111111111111111111111111111111
+    p256_fe_sqr_n(t, t, 2);
+    p256_fe_mul(r, t, a);               // ... 01 = FFFFFFFD
+}
+
+/*
+ * p256_fe_sqrt() - p ≡ 3 (mod 4)이므로 제곱근은 a^((p+1)/4)이다.
+ * (p+1)/4 = 2^254 - 2^222 + 2^190 + 2^94 = (((2^32-1) * 2^32 + 1) * 2^96 + 1) * 2^94이므로
+ * 제곱 253번과 곱셈 7번으로 계산한다. 제곱근이 있으면 1, 없으면 0을 반환한다.
+ */
+int p256_fe_sqrt(p256_fe r, const p256_fe a)
+{
+    p256_fe x2, x4, x8, x16, x32, t;
+
+    p256_fe_sqr(x2, a);
+    p256_fe_mul(x2, x2, a);             // 2^2 - 1
+    p256_fe_sqr_n(x4, x2, 2);
+    p256_fe_mul(x4, x4, x2);            // 2^4 - 1
+    p256_fe_sqr_n(x8, x4, 4);
+    p256_fe_mul(x8, x8, x4);            // 2^8 - 1
+    p256_fe_sqr_n(x16, x8, 8);
+    p256_fe_mul(x16, x16, x8);          // 2^16 - 1
+    p256_fe_sqr_n(x32, x16, 16);
+    p256_fe_mul(x32, x32, x16);         // 2^32 - 1
+
+    p256_fe_sqr_n(t, x32, 32);
+    p256_fe_mul(t, t, a);               // FFFFFFFF 00000001
+    p256_fe_sqr_n(t, t, 96);
+    p256_fe_mul(t, t, a);               // FFFFFFFF 00000001 00000000 00000000 00000001
+    p256_fe_sqr_n(t, t, 94);
+
+    p256_fe_sqr(x2, t);
+    p256_fe_copy(r, t);
+    return p256_fe_equal(x2, a);
+}
+
+/*
+ * 위수 n에 대한 스칼라 연산
+ */
+
+// 몽고메리 곱셈 r = a*b*R^-1 mod n (CIOS 방식)
+static void p256_sc_montmul(uint64_t r[4], const uint64_t a[4], const uint64_t b[4])
+{
+    uint64_t t[6] = {0, 0, 0, 0, 0, 0}, carry, m, u[4], borrow;
+    u128 acc;
+    int i, j;
+
+    for (i = 0; i < 4; i++) {
+        // t = t + a[i]*b
+        carry = 0;
+        for (j = 0; j < 4; j++) {
+            acc = (u128)a[i] * b[j] + t[j] + carry;
+            t[j] = (uint64_t)acc;
+            carry = (uint64_t)(acc >> 64);
+        }
+        acc = (u128)t[4] + carry;
+        t[4] = (uint64_t)acc;
+        t[5] = (uint64_t)(acc >> 64);
+        // t = (t + m*n) / 2^64
+        m = t[0] * N0;
+        acc = (u128)m * N[0] + t[0];
+        carry = (uint64_t)(acc >> 64);
+        for (j = 1; j < 4; j++) {
+            acc = (u128)m * N[j] + t[j] + carry;
+            t[j-1] = (uint64_t)acc;
+            carry = (uint64_t)(acc >> 64);
+        }
+        acc = (u128)t[4] + carry;
+        t[3] = (uint64_t)acc;
+        t[4] = t[5] + (uint64_t)(acc >> 64);
+    }
+    // t < 2n이므로 한 번만 빼면 된다
+    borrow = sub4(u, t, N);
+    sel4(r, t, u, -(t[4] | (borrow ^ 1)));
+}
+
+// 빅 엔디안 32바이트를 읽어 mod n으로 축약한다. 원래 값이 n보다 작았으면 1을 반환한다
+int p256_sc_from_bytes(p256_sc r, const unsigned char *in)
+{
+    uint64_t t[4];
+    int i, j;
+
+    for (i = 0; i < 4; i++) {
+        r[i] = 0;
+        for (j = 0; j < 8; j++)
+            r[i] = (r[i] << 8) | in[(3-i)*8 + j];
+    }
+    if (sub4(t, r, N))
+        return 1;
+    memcpy(r, t, sizeof(t));
+    return 0;
+}
+
+void p256_sc_to_bytes(unsigned char *out, const p256_sc a)
+{
+    p256_fe_to_bytes(out, a);
+}
+
+int p256_sc_is_zero(const p256_sc a)
+{
+    return p256_fe_is_zero(a);
+}
+
+int p256_sc_equal(const p256_sc a, const p256_sc b)
+{
+    return p256_fe_equal(a, b);
+}
+
+void p256_sc_add(p256_sc r, const p256_sc a, const p256_sc b)
+{
+    uint64_t s[4], t[4], carry, borrow;
+
+    carry = add4(s, a, b);
+    borrow = sub4(t, s, N);
+    sel4(r, s, t, -(carry | (borrow ^ 1)));
+}
+
+void p256_sc_neg(p256_sc r, const p256_sc a)
+{
+    static const p256_sc zero = {0, 0, 0, 0};
+    uint64_t t[4];
+
+    sub4(t, N, a);
+    sel4(r, t, zero, -(uint64_t)p256_sc_is_zero(a));
+}
+
+// r = a*b mod n. 몽고메리 곱셈 결과에 R^2를 한 번 더 곱해 R^-1을 없앤다
+void p256_sc_mul(p256_sc r, const p256_sc a, const p256_sc b)
+{
+    uint64_t t[4];
+    p256_sc_montmul(t, a, b);
+    p256_sc_montmul(r, t, RR_N);
+}
+
+/*
+ * p256_sc_inv() - 페르마 정리로 r = a^(n-2) mod n을 계산한다.
+ * 지수 n - 2는 공개된 상수이므로 4비트 고정 윈도우로 위에서부터 처리하며,
+ * 계산 중에는 몽고메리 형태를 유지하여 곱셈마다 R^2를 곱하는 비용을 없앤다.
+ */
+void p256_sc_inv(p256_sc r, const p256_sc a)
+{
+    static const uint64_t E[4] = {
+        0xf3b9cac2fc63254fULL, 0xbce6faada7179e84ULL, 0xffffffffffffffffULL, 0xffffffff00000000ULL
+    };
+    static const uint64_t one[4] = {1, 0, 0, 0};
+    uint64_t tbl[16][4], x[4];
+    int i, j, w;
+
+    // tbl[i] = a^i (몽고메리 형태), tbl[0] = R mod n
+    p256_sc_montmul(tbl[1], a, RR_N);
+    p256_sc_montmul(tbl[0], one, RR_N);
+    for (i = 2; i < 16; i++)
+        p256_sc_montmul(tbl[i], tbl[i-1], tbl[1]);
+
+    memcpy(x, tbl[0], sizeof(x));
+    for (i = 63; i >= 0; i--) {
+        for (j = 0; j < 4; j++)
+            p256_sc_montmul(x, x, x);
+        w = (int)(E[i/16] >> (4 * (i % 16))) & 0xf;
+        p256_sc_montmul(x, x, tbl[w]);
+    }
+    p256_sc_montmul(r, x, one);
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright(c) 2020-2023 All rights reserved by Heekuck Oh.
+ * 이 프로그램은 한양대학교 ERICA 컴퓨터학부 학생을 위한 교육용으로 제작되었다.
+ * 한양대학교 ERICA 학생이 아닌 자는 이 프로그램을 수정하거나 배포할 수 없다.
+ * 프로그램을 수정할 경우 날짜, 학과, 학번, 이름, 수정 내용을 기록한다.
+ */
+#ifndef _P256_H_
+#define _P256_H_
+#include <stdint.h>
+
+/*
+ * P-256 유한체 GF(p)의 원소로, p = 2^256 - 2^224 + 2^192 + 2^96 - 1이다.
+ * 64비트 림 4개를 리틀 엔디안 순서로 저장하며(v[0]이 최하위 림), 모든 함수는
+ * [0, p) 범위로 완전히 축약된 값을 입력받고 출력한다. 출력과 입력이 같아도 된다.
+ */
+typedef uint64_t p256_fe[4];
+
+/*
+ * 위수 n에 대한 스칼라로, [0, n) 범위의 값을 p256_fe와 같은 림 순서로 저장한다.
+ * 곱셈과 역원은 내부에서만 몽고메리 형태를 사용하므로 저장된 값은 항상 일반 정수이다.
+ */
+typedef uint64_t p256_sc[4];
+
+void p256_fe_set_ui(p256_fe r, uint64_t a);
+void p256_fe_copy(p256_fe r, const p256_fe a);
+void p256_fe_cmov(p256_fe r, const p256_fe a, int flag);
+int p256_fe_from_bytes(p256_fe r, const unsigned char *in);
+void p256_fe_to_bytes(unsigned char *out, const p256_fe a);
+int p256_fe_is_zero(const p256_fe a);
+int p256_fe_equal(const p256_fe a, const p256_fe b);
+void p256_fe_add(p256_fe r, const p256_fe a, const p256_fe b);
+void p256_fe_sub(p256_fe r, const p256_fe a, const p256_fe b);
+void p256_fe_neg(p256_fe r, const p256_fe a);
+void p256_fe_mul(p256_fe r, const p256_fe a, const p256_fe b);
+void p256_fe_sqr(p256_fe r, const p256_fe a);
+void p256_fe_inv(p256_fe r, const p256_fe a);
+int p256_fe_sqrt(p256_fe r, const p256_fe a);
+
+int p256_sc_from_bytes(p256_sc r, const unsigned char *in);
+void p256_sc_to_bytes(unsigned char *out, const p256_sc a);
+int p256_sc_is_zero(const p256_sc a);
+int p256_sc_equal(const p256_sc a, const p256_sc b);
+void p256_sc_add(p256_sc r, const p256_sc a, const p256_sc b);
+void p256_sc_neg(p256_sc r, const p256_sc a);
+void p256_sc_mul(p256_sc r, const p256_sc a, const p256_sc b);
+void p256_sc_inv(p256_sc r, const p256_sc a);
+
+#endif
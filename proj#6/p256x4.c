@@ -0,0 +1,486 @@
+/*
+ * Copyright(c) 2020-2023 All rights reserved by Heekuck Oh.
+ * 이 프로그램은 한양대학교 ERICA 컴퓨터학부 학생을 위한 교육용으로 제작되었다.
+ * 한양대학교 ERICA 학생이 아닌 자는 이 프로그램을 수정하거나 배포할 수 없다.
+ * 프로그램을 수정할 경우 날짜, 학과, 학번, 이름, 수정 내용을 기록한다.
+ */
+#include <string.h>
+#include <pthread.h>
+#include "p256x4.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define P256X4_AVX2
+#include <immintrin.h>
+#endif
+
+#define M29 0x1fffffffULL
+
+/*
+ * 2^29진법 림 연산에 쓰는 상수이다. K2P와 K8P는 2p와 8p를 림 0..7이 각각 2^28, 0x42000000 이상이
+ * 되도록 윗자리에서 빌려 온 형태로 적은 것으로, 림마다 빼도 음수가 되지 않게 더해 두는 값이다.
+ * RR은 R^2 mod p (R = 2^261)이다.
+ */
+static const uint64_t K2P[P256X4_LIMBS] = {
+    0x1ffffffe, 0x1fffffff, 0x1fffffff, 0x200003ff, 0x1fffffff, 0x1fffffff, 0x2007ffff, 0x1fbfffff, 0x1ffffff
+};
+static const uint64_t K8P[P256X4_LIMBS] = {
+    0x5ffffff8, 0x5ffffffd, 0x5ffffffd, 0x60000ffd, 0x5ffffffd, 0x5ffffffd, 0x601ffffd, 0x5efffffd, 0x7fffffd
+};
+static const uint64_t RR[P256X4_LIMBS] = {
+    0xc00, 0x0, 0x1fff0000, 0x1fdfffff, 0x1fbfffff, 0x1fffffff, 0x1fffffff, 0x1ffffffe, 0x13
+};
+static const uint64_t ONE[P256X4_LIMBS] = {1, 0, 0, 0, 0, 0, 0, 0, 0};
+
+/*
+ * 한 레인의 연산. AVX2를 쓸 수 없을 때 네 레인에 차례로 적용하며, AVX2 구현과
+ * 같은 순서로 같은 값을 계산하므로 두 구현의 결과는 항상 같다.
+ */
+
+/*
+ * lane_reduce() - 2^261 미만인 값을 2^258 미만으로 줄인다. 림 0..7의 2^29 이상인 부분은 한 칸 위로 넘기고,
+ * 림 8의 2^24 이상인 부분 top(2^256 단위)은 2^256 ≡ 2^224 - 2^192 - 2^96 + 1 (mod p)로 접어 넣는다.
+ * 빼는 항 때문에 림이 음수가 되지 않도록 2p를 함께 더한다. 모든 올림을 먼저 구한 뒤 한꺼번에 더하므로
+ * 올림이 림을 따라 이어지지 않으며, 결과 림은 0x42000000 미만이다.
+ */
+static void lane_reduce(uint64_t a[P256X4_LIMBS])
+{
+    uint64_t c[P256X4_LIMBS - 1], top;
+    int i;
+
+    for (i = 0; i < P256X4_LIMBS - 1; i++) {
+        c[i] = a[i] >> 29;
+        a[i] &= M29;
+    }
+    top = a[8] >> 24;
+    a[8] &= 0xffffff;
+    for (i = 0; i < P256X4_LIMBS; i++)
+        a[i] += K2P[i];
+    for (i = 0; i < P256X4_LIMBS - 1; i++)
+        a[i+1] += c[i];
+    a[0] += top;
+    a[3] -= top << 9;
+    a[6] -= top << 18;
+    a[7] += top << 21;
+}
+
+/*
+ * lane_mont() - 17열의 곱 t를 몽고메리 축약하여 r = t / 2^261 mod p를 구한다.
+ * p ≡ -1 (mod 2^29)이므로 각 단계의 m은 t[i]의 아래 29비트이고, m*p = m*(p + 1) - m에서
+ * -m은 t[i]의 아래 비트를 지우는 것과 같으며 m*(p + 1) = m*(2^96 + 2^192 - 2^224 + 2^256)은 덧셈 네 번이다.
+ */
+static void lane_mont(uint64_t r[P256X4_LIMBS], uint64_t t[2*P256X4_LIMBS])
+{
+    uint64_t m;
+    int i;
+
+    for (i = 0; i < P256X4_LIMBS; i++) {
+        m = t[i] & M29;
+        t[i+1] += t[i] >> 29;
+        t[i+3] += m << 9;
+        t[i+6] += m << 18;
+        t[i+7] += (m << 29) - (m << 21);
+        t[i+8] += (m << 24) - m;
+    }
+    for (i = P256X4_LIMBS; i < 2*P256X4_LIMBS - 1; i++) {
+        t[i+1] += t[i] >> 29;
+        t[i] &= M29;
+    }
+    memcpy(r, t + P256X4_LIMBS, P256X4_LIMBS * sizeof(uint64_t));
+}
+
+static void lane_mul(uint64_t r[P256X4_LIMBS], const uint64_t a[P256X4_LIMBS], const uint64_t b[P256X4_LIMBS])
+{
+    uint64_t t[2*P256X4_LIMBS] = {0};
+    int i, j;
+
+    for (i = 0; i < P256X4_LIMBS; i++)
+        for (j = 0; j < P256X4_LIMBS; j++)
+            t[i+j] += a[i] * b[j];
+    lane_mont(r, t);
+}
+
+// 대칭인 곱 a_i*a_j (i < j)를 한 번만 계산해 두 배로 더한다
+static void lane_sqr(uint64_t r[P256X4_LIMBS], const uint64_t a[P256X4_LIMBS])
+{
+    uint64_t t[2*P256X4_LIMBS] = {0};
+    int i, j;
+
+    for (i = 0; i < P256X4_LIMBS; i++) {
+        t[2*i] += a[i] * a[i];
+        for (j = i + 1; j < P256X4_LIMBS; j++)
+            t[i+j] += (2 * a[i]) * a[j];
+    }
+    lane_mont(r, t);
+}
+
+static void lane_add(uint64_t r[P256X4_LIMBS], const uint64_t a[P256X4_LIMBS], const uint64_t b[P256X4_LIMBS])
+{
+    int i;
+
+    for (i = 0; i < P256X4_LIMBS; i++)
+        r[i] = a[i] + b[i];
+    lane_reduce(r);
+}
+
+// r = a + 8p - b. b의 림이 K8P의 림보다 작으므로 림마다 빼도 음수가 되지 않는다
+static void lane_sub(uint64_t r[P256X4_LIMBS], const uint64_t a[P256X4_LIMBS], const uint64_t b[P256X4_LIMBS])
+{
+    int i;
+
+    for (i = 0; i < P256X4_LIMBS; i++)
+        r[i] = a[i] + K8P[i] - b[i];
+    lane_reduce(r);
+}
+
+// [0, p) 범위의 p256_fe를 2^29진법으로 바꾼다
+static void lane_from_fe(uint64_t r[P256X4_LIMBS], const p256_fe a)
+{
+    int i, bit, w, s;
+
+    for (i = 0; i < P256X4_LIMBS; i++) {
+        bit = 29 * i;
+        w = bit / 64;
+        s = bit % 64;
+        r[i] = a[w] >> s;
+        if (s > 64 - 29 && w < 3)
+            r[i] |= a[w+1] << (64 - s);
+        r[i] &= M29;
+    }
+}
+
+// 몽고메리 형태인 a를 일반 형태로 되돌린 뒤 [0, p)로 축약해 p256_fe에 넣는다
+static void lane_to_fe(p256_fe r, const uint64_t a[P256X4_LIMBS])
+{
+    uint64_t t[P256X4_LIMBS], w[4] = {0};
+    unsigned char buf[32];
+    int i, bit, s;
+
+    // a/R < 1이므로 결과는 p 이하이고 256비트에 들어간다
+    lane_mul(t, a, ONE);
+    for (i = 0; i < P256X4_LIMBS; i++) {
+        bit = 29 * i;
+        s = bit % 64;
+        w[bit/64] |= t[i] << s;
+        if (s > 64 - 29 && bit/64 < 3)
+            w[bit/64 + 1] |= t[i] >> (64 - s);
+    }
+    for (i = 0; i < 32; i++)
+        buf[i] = (unsigned char)(w[3 - i/8] >> (8 * (7 - i%8)));
+    p256_fe_from_bytes(r, buf);
+}
+
+/*
+ * 레인별 구현. 네 레인을 하나씩 꺼내어 한 레인의 연산을 적용한다.
+ */
+
+static void lane_get(uint64_t r[P256X4_LIMBS], const p256x4_fe a, int l)
+{
+    int i;
+
+    for (i = 0; i < P256X4_LIMBS; i++)
+        r[i] = a[i][l];
+}
+
+static void lane_put(p256x4_fe r, const uint64_t a[P256X4_LIMBS], int l)
+{
+    int i;
+
+    for (i = 0; i < P256X4_LIMBS; i++)
+        r[i][l] = a[i];
+}
+
+static void generic_add(p256x4_fe r, const p256x4_fe a, const p256x4_fe b)
+{
+    uint64_t x[P256X4_LIMBS], y[P256X4_LIMBS];
+    int l;
+
+    for (l = 0; l < 4; l++) {
+        lane_get(x, a, l);
+        lane_get(y, b, l);
+        lane_add(x, x, y);
+        lane_put(r, x, l);
+    }
+}
+
+static void generic_sub(p256x4_fe r, const p256x4_fe a, const p256x4_fe b)
+{
+    uint64_t x[P256X4_LIMBS], y[P256X4_LIMBS];
+    int l;
+
+    for (l = 0; l < 4; l++) {
+        lane_get(x, a, l);
+        lane_get(y, b, l);
+        lane_sub(x, x, y);
+        lane_put(r, x, l);
+    }
+}
+
+static void generic_mul(p256x4_fe r, const p256x4_fe a, const p256x4_fe b)
+{
+    uint64_t x[P256X4_LIMBS], y[P256X4_LIMBS];
+    int l;
+
+    for (l = 0; l < 4; l++) {
+        lane_get(x, a, l);
+        lane_get(y, b, l);
+        lane_mul(x, x, y);
+        lane_put(r, x, l);
+    }
+}
+
+static void generic_sqr(p256x4_fe r, const p256x4_fe a)
+{
+    uint64_t x[P256X4_LIMBS];
+    int l;
+
+    for (l = 0; l < 4; l++) {
+        lane_get(x, a, l);
+        lane_sqr(x, x);
+        lane_put(r, x, l);
+    }
+}
+
+#ifdef P256X4_AVX2
+/*
+ * AVX2 구현. 림 하나의 네 레인을 __m256i 하나에 담고, _mm256_mul_epu32로 각 64비트 칸의
+ * 아래 32비트끼리 곱해 네 레인의 64비트 곱을 한 번에 얻는다. 연산 순서는 한 레인의 연산과 같다.
+ */
+#define AVX2 __attribute__((target("avx2")))
+#define LOAD(a) _mm256_loadu_si256((const __m256i *)(a))
+#define STORE(r, x) _mm256_storeu_si256((__m256i *)(r), (x))
+
+/*
+ * avx2_reduce() - lane_reduce()를 네 레인에 적용하고 결과를 r에 저장한다. 적재와 저장을 연산과
+ * 같은 반복문에 두어, 컴파일러가 배열 복사를 memcpy로 바꾸지 않게 한다.
+ */
+AVX2 static inline void avx2_reduce(p256x4_fe r, __m256i x[P256X4_LIMBS])
+{
+    const __m256i mask = _mm256_set1_epi64x(M29);
+    __m256i c[P256X4_LIMBS], top, v;
+    int i;
+
+    top = _mm256_srli_epi64(x[8], 24);
+    c[0] = top;
+    for (i = 0; i < P256X4_LIMBS - 1; i++)
+        c[i+1] = _mm256_srli_epi64(x[i], 29);
+    for (i = 0; i < P256X4_LIMBS; i++) {
+        v = _mm256_and_si256(x[i], i < P256X4_LIMBS - 1 ? mask : _mm256_set1_epi64x(0xffffff));
+        v = _mm256_add_epi64(v, _mm256_set1_epi64x(K2P[i]));
+        v = _mm256_add_epi64(v, c[i]);
+        if (i == 3)
+            v = _mm256_sub_epi64(v, _mm256_slli_epi64(top, 9));
+        if (i == 6)
+            v = _mm256_sub_epi64(v, _mm256_slli_epi64(top, 18));
+        if (i == 7)
+            v = _mm256_add_epi64(v, _mm256_slli_epi64(top, 21));
+        STORE(r[i], v);
+    }
+}
+
+AVX2 static inline void avx2_mont(p256x4_fe r, __m256i t[2*P256X4_LIMBS])
+{
+    const __m256i mask = _mm256_set1_epi64x(M29);
+    __m256i m;
+    int i;
+
+    for (i = 0; i < P256X4_LIMBS; i++) {
+        m = _mm256_and_si256(t[i], mask);
+        t[i+1] = _mm256_add_epi64(t[i+1], _mm256_srli_epi64(t[i], 29));
+        t[i+3] = _mm256_add_epi64(t[i+3], _mm256_slli_epi64(m, 9));
+        t[i+6] = _mm256_add_epi64(t[i+6], _mm256_slli_epi64(m, 18));
+        t[i+7] = _mm256_add_epi64(t[i+7], _mm256_sub_epi64(_mm256_slli_epi64(m, 29), _mm256_slli_epi64(m, 21)));
+        t[i+8] = _mm256_add_epi64(t[i+8], _mm256_sub_epi64(_mm256_slli_epi64(m, 24), m));
+    }
+    for (i = P256X4_LIMBS; i < 2*P256X4_LIMBS - 1; i++) {
+        t[i+1] = _mm256_add_epi64(t[i+1], _mm256_srli_epi64(t[i], 29));
+        STORE(r[i - P256X4_LIMBS], _mm256_and_si256(t[i], mask));
+    }
+    STORE(r[P256X4_LIMBS - 1], t[2*P256X4_LIMBS - 1]);
+}
+
+AVX2 static void avx2_add(p256x4_fe r, const p256x4_fe a, const p256x4_fe b)
+{
+    __m256i x[P256X4_LIMBS];
+    int i;
+
+    for (i = 0; i < P256X4_LIMBS; i++)
+        x[i] = _mm256_add_epi64(LOAD(a[i]), LOAD(b[i]));
+    avx2_reduce(r, x);
+}
+
+AVX2 static void avx2_sub(p256x4_fe r, const p256x4_fe a, const p256x4_fe b)
+{
+    __m256i x[P256X4_LIMBS];
+    int i;
+
+    for (i = 0; i < P256X4_LIMBS; i++)
+        x[i] = _mm256_sub_epi64(_mm256_add_epi64(LOAD(a[i]), _mm256_set1_epi64x(K8P[i])), LOAD(b[i]));
+    avx2_reduce(r, x);
+}
+
+AVX2 static void avx2_mul(p256x4_fe r, const p256x4_fe a, const p256x4_fe b)
+{
+    __m256i x, t[2*P256X4_LIMBS];
+    int i, j;
+
+    for (i = 0; i < 2*P256X4_LIMBS; i++)
+        t[i] = _mm256_setzero_si256();
+    for (i = 0; i < P256X4_LIMBS; i++) {
+        x = LOAD(a[i]);
+        for (j = 0; j < P256X4_LIMBS; j++)
+            t[i+j] = _mm256_add_epi64(t[i+j], _mm256_mul_epu32(x, LOAD(b[j])));
+    }
+    avx2_mont(r, t);
+}
+
+AVX2 static void avx2_sqr(p256x4_fe r, const p256x4_fe a)
+{
+    __m256i x, x2, t[2*P256X4_LIMBS];
+    int i, j;
+
+    for (i = 0; i < 2*P256X4_LIMBS; i++)
+        t[i] = _mm256_setzero_si256();
+    for (i = 0; i < P256X4_LIMBS; i++) {
+        x = LOAD(a[i]);
+        t[2*i] = _mm256_add_epi64(t[2*i], _mm256_mul_epu32(x, x));
+        x2 = _mm256_add_epi64(x, x);
+        for (j = i + 1; j < P256X4_LIMBS; j++)
+            t[i+j] = _mm256_add_epi64(t[i+j], _mm256_mul_epu32(x2, LOAD(a[j])));
+    }
+    avx2_mont(r, t);
+}
+#endif
+
+/*
+ * 실행 중에 고르는 구현이다. p256x4_init()이 CPU가 AVX2를 지원하는지 한 번만 확인하여
+ * 바꾸며, 그 전에는 레인별 구현을 쓴다.
+ */
+static void (*impl_add)(p256x4_fe, const p256x4_fe, const p256x4_fe) = generic_add;
+static void (*impl_sub)(p256x4_fe, const p256x4_fe, const p256x4_fe) = generic_sub;
+static void (*impl_mul)(p256x4_fe, const p256x4_fe, const p256x4_fe) = generic_mul;
+static void (*impl_sqr)(p256x4_fe, const p256x4_fe) = generic_sqr;
+static int use_avx2;
+static pthread_once_t impl_once = PTHREAD_ONCE_INIT;
+
+static void impl_init(void)
+{
+#ifdef P256X4_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        impl_add = avx2_add;
+        impl_sub = avx2_sub;
+        impl_mul = avx2_mul;
+        impl_sqr = avx2_sqr;
+        use_avx2 = 1;
+    }
+#endif
+}
+
+/*
+ * p256x4_init() - 이 CPU에서 쓸 구현을 고른다. 여러 번 불러도 되며 다른 함수보다 먼저 불러야 한다.
+ */
+void p256x4_init(void)
+{
+    pthread_once(&impl_once, impl_init);
+}
+
+// AVX2 구현을 쓰고 있으면 1을 반환한다
+int p256x4_has_avx2(void)
+{
+    return use_avx2;
+}
+
+// 한 레인 분량의 원소 r에 a의 몽고메리 형태를 넣는다
+void p256x4_elt_from_fe(p256x4_elt r, const p256_fe a)
+{
+    uint64_t t[P256X4_LIMBS];
+    int i;
+
+    lane_from_fe(t, a);
+    lane_mul(t, t, RR);
+    for (i = 0; i < P256X4_LIMBS; i++)
+        r[i] = (uint32_t)t[i];
+}
+
+// flag가 0이 아니면 r = a로 분기 없이 바꾼다
+void p256x4_elt_cmov(p256x4_elt r, const p256x4_elt a, int flag)
+{
+    uint32_t mask = -(uint32_t)(flag != 0);
+    int i;
+
+    for (i = 0; i < P256X4_LIMBS; i++)
+        r[i] ^= mask & (r[i] ^ a[i]);
+}
+
+// 네 레인에 a[0..3]을 차례로 넣는다
+void p256x4_load(p256x4_fe r, const p256x4_elt a[4])
+{
+    int i, l;
+
+    for (i = 0; i < P256X4_LIMBS; i++)
+        for (l = 0; l < 4; l++)
+            r[i][l] = a[l][i];
+}
+
+// 네 레인에 a[0..3]의 몽고메리 형태를 넣는다
+void p256x4_from_fe(p256x4_fe r, const p256_fe a[4])
+{
+    uint64_t t[P256X4_LIMBS];
+    int l;
+
+    for (l = 0; l < 4; l++) {
+        lane_from_fe(t, a[l]);
+        lane_mul(t, t, RR);
+        lane_put(r, t, l);
+    }
+}
+
+// 네 레인의 값을 [0, p)로 축약하여 r[0..3]에 꺼낸다
+void p256x4_to_fe(p256_fe r[4], const p256x4_fe a)
+{
+    uint64_t t[P256X4_LIMBS];
+    int l;
+
+    for (l = 0; l < 4; l++) {
+        lane_get(t, a, l);
+        lane_to_fe(r[l], t);
+    }
+}
+
+void p256x4_copy(p256x4_fe r, const p256x4_fe a)
+{
+    memcpy(r, a, sizeof(p256x4_fe));
+}
+
+// flag[l]이 0이 아닌 레인만 r = a로 분기 없이 바꾼다
+void p256x4_cmov(p256x4_fe r, const p256x4_fe a, const int flag[4])
+{
+    uint64_t mask[4];
+    int i, l;
+
+    for (l = 0; l < 4; l++)
+        mask[l] = -(uint64_t)(flag[l] != 0);
+    for (i = 0; i < P256X4_LIMBS; i++)
+        for (l = 0; l < 4; l++)
+            r[i][l] ^= mask[l] & (r[i][l] ^ a[i][l]);
+}
+
+void p256x4_add(p256x4_fe r, const p256x4_fe a, const p256x4_fe b)
+{
+    impl_add(r, a, b);
+}
+
+void p256x4_sub(p256x4_fe r, const p256x4_fe a, const p256x4_fe b)
+{
+    impl_sub(r, a, b);
+}
+
+void p256x4_mul(p256x4_fe r, const p256x4_fe a, const p256x4_fe b)
+{
+    impl_mul(r, a, b);
+}
+
+void p256x4_sqr(p256x4_fe r, const p256x4_fe a)
+{
+    impl_sqr(r, a);
+}
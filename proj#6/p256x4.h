@@ -0,0 +1,41 @@
+/*
+ * Copyright(c) 2020-2023 All rights reserved by Heekuck Oh.
+ * 이 프로그램은 한양대학교 ERICA 컴퓨터학부 학생을 위한 교육용으로 제작되었다.
+ * 한양대학교 ERICA 학생이 아닌 자는 이 프로그램을 수정하거나 배포할 수 없다.
+ * 프로그램을 수정할 경우 날짜, 학과, 학번, 이름, 수정 내용을 기록한다.
+ */
+#ifndef _P256X4_H_
+#define _P256X4_H_
+#include <stdint.h>
+#include "p256.h"
+
+#define P256X4_LIMBS 9
+
+/*
+ * 서로 독립인 P-256 유한체 원소 네 개를 한꺼번에 다루는 4레인 원소이다.
+ * 각 원소는 2^29진법의 림 9개로 나타내며 v[i][l]은 레인 l의 i번째 림이다.
+ * 값은 R = 2^261인 몽고메리 형태로 저장되고 [0, p)로 완전히 축약하지 않는다.
+ * 값은 2^258 미만, 림 0..7은 0x42000000 미만, 림 8은 2^26 미만으로 유지되어 곱셈의 열 합이 64비트를 넘지 않는다.
+ */
+typedef uint64_t p256x4_fe[P256X4_LIMBS][4];
+
+// 한 레인 분량의 원소로, 미리 계산해 두는 표에 p256x4_fe와 같은 몽고메리 형태로 저장한다
+typedef uint32_t p256x4_elt[P256X4_LIMBS];
+
+void p256x4_init(void);
+int p256x4_has_avx2(void);
+
+void p256x4_elt_from_fe(p256x4_elt r, const p256_fe a);
+void p256x4_elt_cmov(p256x4_elt r, const p256x4_elt a, int flag);
+void p256x4_load(p256x4_fe r, const p256x4_elt a[4]);
+void p256x4_from_fe(p256x4_fe r, const p256_fe a[4]);
+void p256x4_to_fe(p256_fe r[4], const p256x4_fe a);
+
+void p256x4_copy(p256x4_fe r, const p256x4_fe a);
+void p256x4_cmov(p256x4_fe r, const p256x4_fe a, const int flag[4]);
+void p256x4_add(p256x4_fe r, const p256x4_fe a, const p256x4_fe b);
+void p256x4_sub(p256x4_fe r, const p256x4_fe a, const p256x4_fe b);
+void p256x4_mul(p256x4_fe r, const p256x4_fe a, const p256x4_fe b);
+void p256x4_sqr(p256x4_fe r, const p256x4_fe a);
+
+#endif
@@ -0,0 +1,452 @@
+/*
+ * Copyright(c) 2020-2023 All rights reserved by Heekuck Oh.
+ * 이 프로그램은 한양대학교 ERICA 컴퓨터학부 학생을 위한 교육용으로 제작되었다.
+ * 한양대학교 ERICA 학생이 아닌 자는 이 프로그램을 수정하거나 배포할 수 없다.
+ * 프로그램을 수정할 경우 날짜, 학과, 학번, 이름, 수정 내용을 기록한다.
+ */
+#include <string.h>
+#include "p384.h"
+
+typedef unsigned __int128 u128;
+
+#define L P384_LIMBS
+
+// p = 2^384 - 2^128 - 2^96 + 2^32 - 1
+static const uint64_t P[L] = {
+    0x00000000ffffffffULL, 0xffffffff00000000ULL, 0xfffffffffffffffeULL,
+    0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL
+};
+
+// n = FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFC7634D81F4372DDF581A0DB248B0A77AECEC196ACCC52973
+static const uint64_t N[L] = {
+    0xecec196accc52973ULL, 0x581a0db248b0a77aULL, 0xc7634d81f4372ddfULL,
+    0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL
+};
+
+// 몽고메리 곱셈에 사용하는 -n^-1 mod 2^64와 R^2 mod n (R = 2^384)
+static const uint64_t N0 = 0x6ed46089e88fdc45ULL;
+static const uint64_t RR_N[L] = {
+    0x2d319b2419b409a9ULL, 0xff3d81e5df1aa419ULL, 0xbc3e483afcb82947ULL,
+    0xd40d49174aab1cc5ULL, 0x3fb05b7a28266895ULL, 0x0c84ee012b39bf21ULL
+};
+
+/*
+ * 림 단위 보조 함수
+ */
+
+// r = a + b, 올림수를 반환한다
+static uint64_t add6(uint64_t r[L], const uint64_t a[L], const uint64_t b[L])
+{
+    u128 acc = 0;
+    int i;
+    for (i = 0; i < L; i++) {
+        acc += (u128)a[i] + b[i];
+        r[i] = (uint64_t)acc;
+        acc >>= 64;
+    }
+    return (uint64_t)acc;
+}
+
+// r = a - b, 빌림수를 반환한다
+static uint64_t sub6(uint64_t r[L], const uint64_t a[L], const uint64_t b[L])
+{
+    uint64_t borrow = 0, t, u;
+    int i;
+    for (i = 0; i < L; i++) {
+        t = a[i] - b[i];
+        u = (a[i] < b[i]) | (t < borrow);
+        r[i] = t - borrow;
+        borrow = u;
+    }
+    return borrow;
+}
+
+// mask가 모두 1이면 r = b, 0이면 r = a로 분기 없이 선택한다
+static void sel6(uint64_t r[L], const uint64_t a[L], const uint64_t b[L], uint64_t mask)
+{
+    int i;
+    for (i = 0; i < L; i++)
+        r[i] = a[i] ^ (mask & (a[i] ^ b[i]));
+}
+
+// t = a * b (768비트)
+static void mul6(uint64_t t[2*L], const uint64_t a[L], const uint64_t b[L])
+{
+    u128 acc;
+    uint64_t carry;
+    int i, j;
+
+    memset(t, 0, 2 * L * sizeof(uint64_t));
+    for (i = 0; i < L; i++) {
+        carry = 0;
+        for (j = 0; j < L; j++) {
+            acc = (u128)a[i] * b[j] + t[i+j] + carry;
+            t[i+j] = (uint64_t)acc;
+            carry = (uint64_t)(acc >> 64);
+        }
+        t[i+L] = carry;
+    }
+}
+
+// t = a^2 (768비트). 교차항은 한 번만 곱한 뒤 두 배로 만든다
+static void sqr6(uint64_t t[2*L], const uint64_t a[L])
+{
+    u128 acc;
+    uint64_t carry;
+    int i, j;
+
+    memset(t, 0, 2 * L * sizeof(uint64_t));
+    for (i = 0; i < L - 1; i++) {
+        carry = 0;
+        for (j = i + 1; j < L; j++) {
+            acc = (u128)a[i] * a[j] + t[i+j] + carry;
+            t[i+j] = (uint64_t)acc;
+            carry = (uint64_t)(acc >> 64);
+        }
+        t[i+L] = carry;
+    }
+    t[2*L-1] = t[2*L-2] >> 63;
+    for (i = 2*L - 2; i > 0; i--)
+        t[i] = (t[i] << 1) | (t[i-1] >> 63);
+    t[0] <<= 1;
+    carry = 0;
+    for (i = 0; i < L; i++) {
+        acc = (u128)a[i] * a[i] + t[2*i] + carry;
+        t[2*i] = (uint64_t)acc;
+        acc = (acc >> 64) + t[2*i+1];
+        t[2*i+1] = (uint64_t)acc;
+        carry = (uint64_t)(acc >> 64);
+    }
+}
+
+/*
+ * p384_reduce() - 768비트 t를 mod p로 축약한다.
+ * FIPS 186-4 D.2.4의 빠른 축약 r = T + 2S1 + S2 + S3 + S4 + S5 + S6 - D1 - D2 - D3 (mod p)를
+ * 32비트 워드 c0..c23 단위의 부호 있는 64비트 누적으로 계산한 뒤 올림을 한 번 전파한다.
+ * 남은 작은 올림 c는 2^384 = 2^128 + 2^96 - 2^32 + 1 (mod p)을 이용해 한 번 더 접는다.
+ */
+static void p384_reduce(p384_fe r, const uint64_t t[2*L])
+{
+    int64_t c[24], a[12], carry;
+    uint64_t v[L], vm[L], vp[L], borrow, m_pos, m_neg, m_zero;
+    int i;
+
+    for (i = 0; i < 2*L; i++) {
+        c[2*i] = (int64_t)(t[i] & 0xffffffffULL);
+        c[2*i+1] = (int64_t)(t[i] >> 32);
+    }
+    a[0] = c[0] + c[12] + c[21] + c[20] - c[23];
+    a[1] = c[1] + c[13] + c[22] + c[23] - c[12] - c[20];
+    a[2] = c[2] + c[14] + c[23] - c[13] - c[21];
+    a[3] = c[3] + c[15] + c[12] + c[20] + c[21] - c[14] - c[22] - c[23];
+    a[4] = c[4] + 2*c[21] + c[16] + c[13] + c[12] + c[20] + c[22] - c[15] - 2*c[23];
+    a[5] = c[5] + 2*c[22] + c[17] + c[14] + c[13] + c[21] + c[23] - c[16];
+    a[6] = c[6] + 2*c[23] + c[18] + c[15] + c[14] + c[22] - c[17];
+    a[7] = c[7] + c[19] + c[16] + c[15] + c[23] - c[18];
+    a[8] = c[8] + c[20] + c[17] + c[16] - c[19];
+    a[9] = c[9] + c[21] + c[18] + c[17] - c[20];
+    a[10] = c[10] + c[22] + c[19] + c[18] - c[21];
+    a[11] = c[11] + c[23] + c[20] + c[19] - c[22];
+
+    for (i = 0; i < 11; i++) {
+        a[i+1] += a[i] >> 32;
+        a[i] &= 0xffffffff;
+    }
+    carry = a[11] >> 32;
+    a[11] &= 0xffffffff;
+    // c*2^384 = c*(2^128 + 2^96 - 2^32 + 1)
+    a[0] += carry;
+    a[1] -= carry;
+    a[3] += carry;
+    a[4] += carry;
+    for (i = 0; i < 11; i++) {
+        a[i+1] += a[i] >> 32;
+        a[i] &= 0xffffffff;
+    }
+    carry = a[11] >> 32;
+    for (i = 0; i < L; i++)
+        v[i] = (uint64_t)(a[2*i] & 0xffffffff) | ((uint64_t)a[2*i+1] << 32);
+
+    // 값은 v + carry*2^384이고 carry는 -1, 0, 1 중 하나이다
+    borrow = sub6(vm, v, P);
+    add6(vp, v, P);
+    m_pos = -(uint64_t)(carry == 1);
+    m_neg = -(uint64_t)(carry == -1);
+    m_zero = -(uint64_t)(carry == 0);
+    sel6(v, v, vm, m_pos | (m_zero & (borrow - 1)));
+    sel6(r, v, vp, m_neg);
+}
+
+/*
+ * 유한체 GF(p) 연산
+ */
+
+void p384_fe_set_ui(p384_fe r, uint64_t a)
+{
+    memset(r, 0, sizeof(p384_fe));
+    r[0] = a;
+}
+
+void p384_fe_copy(p384_fe r, const p384_fe a)
+{
+    memcpy(r, a, sizeof(p384_fe));
+}
+
+void p384_fe_cmov(p384_fe r, const p384_fe a, int flag)
+{
+    sel6(r, r, a, -(uint64_t)(flag != 0));
+}
+
+// 빅 엔디안 48바이트를 읽는다. 값이 p 이상이면 mod p로 축약하고 0을 반환한다
+int p384_fe_from_bytes(p384_fe r, const unsigned char *in)
+{
+    uint64_t t[L];
+    int i, j;
+
+    for (i = 0; i < L; i++) {
+        r[i] = 0;
+        for (j = 0; j < 8; j++)
+            r[i] = (r[i] << 8) | in[(L-1-i)*8 + j];
+    }
+    if (sub6(t, r, P))
+        return 1;
+    memcpy(r, t, sizeof(t));
+    return 0;
+}
+
+void p384_fe_to_bytes(unsigned char *out, const p384_fe a)
+{
+    int i, j;
+    for (i = 0; i < L; i++)
+        for (j = 0; j < 8; j++)
+            out[(L-1-i)*8 + j] = (unsigned char)(a[i] >> (56 - 8*j));
+}
+
+int p384_fe_is_zero(const p384_fe a)
+{
+    return (a[0] | a[1] | a[2] | a[3] | a[4] | a[5]) == 0;
+}
+
+int p384_fe_equal(const p384_fe a, const p384_fe b)
+{
+    uint64_t t = 0;
+    int i;
+    for (i = 0; i < L; i++)
+        t |= a[i] ^ b[i];
+    return t == 0;
+}
+
+void p384_fe_add(p384_fe r, const p384_fe a, const p384_fe b)
+{
+    uint64_t s[L], t[L], carry, borrow;
+
+    carry = add6(s, a, b);
+    borrow = sub6(t, s, P);
+    sel6(r, s, t, -(carry | (borrow ^ 1)));
+}
+
+void p384_fe_sub(p384_fe r, const p384_fe a, const p384_fe b)
+{
+    uint64_t d[L], t[L], borrow;
+
+    borrow = sub6(d, a, b);
+    add6(t, d, P);
+    sel6(r, d, t, -borrow);
+}
+
+void p384_fe_neg(p384_fe r, const p384_fe a)
+{
+    static const p384_fe zero = {0, 0, 0, 0, 0, 0};
+    p384_fe_sub(r, zero, a);
+}
+
+void p384_fe_mul(p384_fe r, const p384_fe a, const p384_fe b)
+{
+    uint64_t t[2*L];
+    mul6(t, a, b);
+    p384_reduce(r, t);
+}
+
+void p384_fe_sqr(p384_fe r, const p384_fe a)
+{
+    uint64_t t[2*L];
+    sqr6(t, a);
+    p384_reduce(r, t);
+}
+
+// r = a^(2^k)
+static void p384_fe_sqr_n(p384_fe r, const p384_fe a, int k)
+{
+    p384_fe_sqr(r, a);
+    while (--k > 0)
+        p384_fe_sqr(r, r);
+}
+
+/*
+ * p384_fe_inv() - 페르마 정리로 r = a^(p-2)를 계산한다.
+ * p - 2는 위에서부터 1이 255개, 0, 1이 32개, 0이 64개, 1이 30개, 01이다.
+ * x_k = a^(2^k - 1)을 만든 뒤 제곱 383번과 곱셈 15번의 고정된 사슬로 계산한다.
+ */
+void p384_fe_inv(p384_fe r, const p384_fe a)
+{
+    p384_fe x2, x3, x6, x12, x15, x30, x32, x60, x120, t;
+
+    p384_fe_sqr(x2, a);
+    p384_fe_mul(x2, x2, a);             // 2^2 - 1
+    p384_fe_sqr(x3, x2);
+    p384_fe_mul(x3, x3, a);             // 2^3 - 1
+    p384_fe_sqr_n(x6, x3, 3);
+    p384_fe_mul(x6, x6, x3);            // 2^6 - 1
+    p384_fe_sqr_n(x12, x6, 6);
+    p384_fe_mul(x12, x12, x6);          // 2^12 - 1
+    p384_fe_sqr_n(x15, x12, 3);
+    p384_fe_mul(x15, x15, x3);          // 2^15 - 1
+    p384_fe_sqr_n(x30, x15, 15);
+    p384_fe_mul(x30, x30, x15);         // 2^30 - 1
+    p384_fe_sqr_n(x32, x30, 2);
+    p384_fe_mul(x32, x32, x2);          // 2^32 - 1
+    p384_fe_sqr_n(x60, x30, 30);
+    p384_fe_mul(x60, x60, x30);         // 2^60 - 1
+    p384_fe_sqr_n(x120, x60, 60);
+    p384_fe_mul(x120, x120, x60);       // 2^120 - 1
+    p384_fe_sqr_n(t, x120, 120);
+    p384_fe_mul(t, t, x120);            // 2^240 - 1
+    p384_fe_sqr_n(t, t, 15);
+    p384_fe_mul(t, t, x15);             // 2^255 - 1
+
+    p384_fe_sqr_n(t, t, 33);
+    p384_fe_mul(t, t, x32);             // ... FFFFFFFE FFFFFFFF
+    p384_fe_sqr_n(t, t, 94);
+    p384_fe_mul(t, t, x30);             // ... 00000000 00000000 + 1이 30개
+    p384_fe_sqr_n(t, t, 2);
+    p384_fe_mul(r, t, a);               // ... FFFFFFFD
+}
+
+/*
+ * 위수 n에 대한 스칼라 연산
+ */
+
+// 몽고메리 곱셈 r = a*b*R^-1 mod n (CIOS 방식)
+static void p384_sc_montmul(uint64_t r[L], const uint64_t a[L], const uint64_t b[L])
+{
+    uint64_t t[L+2], carry, m, u[L], borrow;
+    u128 acc;
+    int i, j;
+
+    memset(t, 0, sizeof(t));
+    for (i = 0; i < L; i++) {
+        // t = t + a[i]*b
+        carry = 0;
+        for (j = 0; j < L; j++) {
+            acc = (u128)a[i] * b[j] + t[j] + carry;
+            t[j] = (uint64_t)acc;
+            carry = (uint64_t)(acc >> 64);
+        }
+        acc = (u128)t[L] + carry;
+        t[L] = (uint64_t)acc;
+        t[L+1] = (uint64_t)(acc >> 64);
+        // t = (t + m*n) / 2^64
+        m = t[0] * N0;
+        acc = (u128)m * N[0] + t[0];
+        carry = (uint64_t)(acc >> 64);
+        for (j = 1; j < L; j++) {
+            acc = (u128)m * N[j] + t[j] + carry;
+            t[j-1] = (uint64_t)acc;
+            carry = (uint64_t)(acc >> 64);
+        }
+        acc = (u128)t[L] + carry;
+        t[L-1] = (uint64_t)acc;
+        t[L] = t[L+1] + (uint64_t)(acc >> 64);
+    }
+    // t < 2n이므로 한 번만 빼면 된다
+    borrow = sub6(u, t, N);
+    sel6(r, t, u, -(t[L] | (borrow ^ 1)));
+}
+
+// 빅 엔디안 48바이트를 읽어 mod n으로 축약한다. 원래 값이 n보다 작았으면 1을 반환한다
+int p384_sc_from_bytes(p384_sc r, const unsigned char *in)
+{
+    uint64_t t[L];
+    int i, j;
+
+    for (i = 0; i < L; i++) {
+        r[i] = 0;
+        for (j = 0; j < 8; j++)
+            r[i] = (r[i] << 8) | in[(L-1-i)*8 + j];
+    }
+    // 2^384 < 2n이므로 n을 한 번만 빼면 된다
+    if (sub6(t, r, N))
+        return 1;
+    memcpy(r, t, sizeof(t));
+    return 0;
+}
+
+void p384_sc_to_bytes(unsigned char *out, const p384_sc a)
+{
+    p384_fe_to_bytes(out, a);
+}
+
+int p384_sc_is_zero(const p384_sc a)
+{
+    return p384_fe_is_zero(a);
+}
+
+int p384_sc_equal(const p384_sc a, const p384_sc b)
+{
+    return p384_fe_equal(a, b);
+}
+
+void p384_sc_add(p384_sc r, const p384_sc a, const p384_sc b)
+{
+    uint64_t s[L], t[L], carry, borrow;
+
+    carry = add6(s, a, b);
+    borrow = sub6(t, s, N);
+    sel6(r, s, t, -(carry | (borrow ^ 1)));
+}
+
+void p384_sc_neg(p384_sc r, const p384_sc a)
+{
+    static const p384_sc zero = {0, 0, 0, 0, 0, 0};
+    uint64_t t[L];
+
+    sub6(t, N, a);
+    sel6(r, t, zero, -(uint64_t)p384_sc_is_zero(a));
+}
+
+// r = a*b mod n. 몽고메리 곱셈 결과에 R^2를 한 번 더 곱해 R^-1을 없앤다
+void p384_sc_mul(p384_sc r, const p384_sc a, const p384_sc b)
+{
+    uint64_t t[L];
+    p384_sc_montmul(t, a, b);
+    p384_sc_montmul(r, t, RR_N);
+}
+
+/*
+ * p384_sc_inv() - 페르마 정리로 r = a^(n-2) mod n을 p256_sc_inv()와 같은 4비트 고정 윈도우로 계산한다.
+ */
+void p384_sc_inv(p384_sc r, const p384_sc a)
+{
+    static const uint64_t E[L] = {
+        0xecec196accc52971ULL, 0x581a0db248b0a77aULL, 0xc7634d81f4372ddfULL,
+        0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL
+    };
+    static const uint64_t one[L] = {1, 0, 0, 0, 0, 0};
+    uint64_t tbl[16][L], x[L];
+    int i, j, w;
+
+    // tbl[i] = a^i (몽고메리 형태), tbl[0] = R mod n
+    p384_sc_montmul(tbl[1], a, RR_N);
+    p384_sc_montmul(tbl[0], one, RR_N);
+    for (i = 2; i < 16; i++)
+        p384_sc_montmul(tbl[i], tbl[i-1], tbl[1]);
+
+    memcpy(x, tbl[0], sizeof(x));
+    for (i = 16*L - 1; i >= 0; i--) {
+        for (j = 0; j < 4; j++)
+            p384_sc_montmul(x, x, x);
+        w = (int)(E[i/16] >> (4 * (i % 16))) & 0xf;
+        p384_sc_montmul(x, x, tbl[w]);
+    }
+    p384_sc_montmul(r, x, one);
+}
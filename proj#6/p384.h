@@ -0,0 +1,45 @@
+/*
+ * Copyright(c) 2020-2023 All rights reserved by Heekuck Oh.
+ * 이 프로그램은 한양대학교 ERICA 컴퓨터학부 학생을 위한 교육용으로 제작되었다.
+ * 한양대학교 ERICA 학생이 아닌 자는 이 프로그램을 수정하거나 배포할 수 없다.
+ * 프로그램을 수정할 경우 날짜, 학과, 학번, 이름, 수정 내용을 기록한다.
+ */
+#ifndef _P384_H_
+#define _P384_H_
+#include <stdint.h>
+
+#define P384_LIMBS 6
+
+/*
+ * P-384 유한체 GF(p)의 원소로, p = 2^384 - 2^128 - 2^96 + 2^32 - 1이다.
+ * 64비트 림 6개를 리틀 엔디안 순서로 저장하며, p256_fe와 같이 [0, p) 범위의 값만 주고받는다.
+ */
+typedef uint64_t p384_fe[P384_LIMBS];
+
+// 위수 n에 대한 스칼라로 [0, n) 범위의 일반 정수를 저장한다
+typedef uint64_t p384_sc[P384_LIMBS];
+
+void p384_fe_set_ui(p384_fe r, uint64_t a);
+void p384_fe_copy(p384_fe r, const p384_fe a);
+void p384_fe_cmov(p384_fe r, const p384_fe a, int flag);
+int p384_fe_from_bytes(p384_fe r, const unsigned char *in);
+void p384_fe_to_bytes(unsigned char *out, const p384_fe a);
+int p384_fe_is_zero(const p384_fe a);
+int p384_fe_equal(const p384_fe a, const p384_fe b);
+void p384_fe_add(p384_fe r, const p384_fe a, const p384_fe b);
+void p384_fe_sub(p384_fe r, const p384_fe a, const p384_fe b);
+void p384_fe_neg(p384_fe r, const p384_fe a);
+void p384_fe_mul(p384_fe r, const p384_fe a, const p384_fe b);
+void p384_fe_sqr(p384_fe r, const p384_fe a);
+void p384_fe_inv(p384_fe r, const p384_fe a);
+
+int p384_sc_from_bytes(p384_sc r, const unsigned char *in);
+void p384_sc_to_bytes(unsigned char *out, const p384_sc a);
+int p384_sc_is_zero(const p384_sc a);
+int p384_sc_equal(const p384_sc a, const p384_sc b);
+void p384_sc_add(p384_sc r, const p384_sc a, const p384_sc b);
+void p384_sc_neg(p384_sc r, const p384_sc a);
+void p384_sc_mul(p384_sc r, const p384_sc a, const p384_sc b);
+void p384_sc_inv(p384_sc r, const p384_sc a);
+
+#endif
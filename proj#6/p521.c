@@ -0,0 +1,432 @@
+/*
+ * Copyright(c) 2020-2023 All rights reserved by Heekuck Oh.
+ * 이 프로그램은 한양대학교 ERICA 컴퓨터학부 학생을 위한 교육용으로 제작되었다.
+ * 한양대학교 ERICA 학생이 아닌 자는 이 프로그램을 수정하거나 배포할 수 없다.
+ * 프로그램을 수정할 경우 날짜, 학과, 학번, 이름, 수정 내용을 기록한다.
+ */
+#include <string.h>
+#include "p521.h"
+
+typedef unsigned __int128 u128;
+
+#define L P521_LIMBS
+#define P521_BYTES 66
+#define TOP_MASK 0x1ffULL
+
+// p = 2^521 - 1
+static const uint64_t P[L] = {
+    0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL,
+    0xffffffffffffffffULL, 0xffffffffffffffffULL, 0xffffffffffffffffULL,
+    0xffffffffffffffffULL, 0xffffffffffffffffULL, 0x00000000000001ffULL
+};
+
+// n = 01FF...FFFA51868783BF2F966B7FCC0148F709A5D03BB5C9B8899C47AEBB6FB71E91386409
+static const uint64_t N[L] = {
+    0xbb6fb71e91386409ULL, 0x3bb5c9b8899c47aeULL, 0x7fcc0148f709a5d0ULL,
+    0x51868783bf2f966bULL, 0xfffffffffffffffaULL, 0xffffffffffffffffULL,
+    0xffffffffffffffffULL, 0xffffffffffffffffULL, 0x00000000000001ffULL
+};
+
+// 몽고메리 곱셈에 사용하는 -n^-1 mod 2^64와 R^2 mod n (R = 2^576)
+static const uint64_t N0 = 0x1d2f5ccd79a995c7ULL;
+static const uint64_t RR_N[L] = {
+    0x137cd04dcf15dd04ULL, 0xf707badce5547ea3ULL, 0x12a78d38794573ffULL,
+    0xd3721ef557f75e06ULL, 0xdd6e23d82e49c7dbULL, 0xcff3d142b7756e3eULL,
+    0x5bcc6d61a8e567bcULL, 0x2d8e03d1492d0d45ULL, 0x000000000000003dULL
+};
+
+/*
+ * 림 단위 보조 함수
+ */
+
+// r = a + b, 올림수를 반환한다
+static uint64_t add9(uint64_t r[L], const uint64_t a[L], const uint64_t b[L])
+{
+    u128 acc = 0;
+    int i;
+    for (i = 0; i < L; i++) {
+        acc += (u128)a[i] + b[i];
+        r[i] = (uint64_t)acc;
+        acc >>= 64;
+    }
+    return (uint64_t)acc;
+}
+
+// r = a - b, 빌림수를 반환한다
+static uint64_t sub9(uint64_t r[L], const uint64_t a[L], const uint64_t b[L])
+{
+    uint64_t borrow = 0, t, u;
+    int i;
+    for (i = 0; i < L; i++) {
+        t = a[i] - b[i];
+        u = (a[i] < b[i]) | (t < borrow);
+        r[i] = t - borrow;
+        borrow = u;
+    }
+    return borrow;
+}
+
+// mask가 모두 1이면 r = b, 0이면 r = a로 분기 없이 선택한다
+static void sel9(uint64_t r[L], const uint64_t a[L], const uint64_t b[L], uint64_t mask)
+{
+    int i;
+    for (i = 0; i < L; i++)
+        r[i] = a[i] ^ (mask & (a[i] ^ b[i]));
+}
+
+// t = a * b (1042비트)
+static void mul9(uint64_t t[2*L], const uint64_t a[L], const uint64_t b[L])
+{
+    u128 acc;
+    uint64_t carry;
+    int i, j;
+
+    memset(t, 0, 2 * L * sizeof(uint64_t));
+    for (i = 0; i < L; i++) {
+        carry = 0;
+        for (j = 0; j < L; j++) {
+            acc = (u128)a[i] * b[j] + t[i+j] + carry;
+            t[i+j] = (uint64_t)acc;
+            carry = (uint64_t)(acc >> 64);
+        }
+        t[i+L] = carry;
+    }
+}
+
+// t = a^2 (1042비트). 교차항은 한 번만 곱한 뒤 두 배로 만든다
+static void sqr9(uint64_t t[2*L], const uint64_t a[L])
+{
+    u128 acc;
+    uint64_t carry;
+    int i, j;
+
+    memset(t, 0, 2 * L * sizeof(uint64_t));
+    for (i = 0; i < L - 1; i++) {
+        carry = 0;
+        for (j = i + 1; j < L; j++) {
+            acc = (u128)a[i] * a[j] + t[i+j] + carry;
+            t[i+j] = (uint64_t)acc;
+            carry = (uint64_t)(acc >> 64);
+        }
+        t[i+L] = carry;
+    }
+    t[2*L-1] = t[2*L-2] >> 63;
+    for (i = 2*L - 2; i > 0; i--)
+        t[i] = (t[i] << 1) | (t[i-1] >> 63);
+    t[0] <<= 1;
+    carry = 0;
+    for (i = 0; i < L; i++) {
+        acc = (u128)a[i] * a[i] + t[2*i] + carry;
+        t[2*i] = (uint64_t)acc;
+        acc = (acc >> 64) + t[2*i+1];
+        t[2*i+1] = (uint64_t)acc;
+        carry = (uint64_t)(acc >> 64);
+    }
+}
+
+// 빅 엔디안 66바이트를 림으로 읽는다
+static void load66(uint64_t r[L], const unsigned char *in)
+{
+    int k;
+
+    memset(r, 0, L * sizeof(uint64_t));
+    for (k = 0; k < P521_BYTES; k++)
+        r[k/8] |= (uint64_t)in[P521_BYTES-1-k] << (8 * (k % 8));
+}
+
+/*
+ * p521_fold() - 최상위 림에 9비트를 넘는 올림 c가 있으면 2^521 = 1 (mod p)로 접은 뒤 p 이상이면 p를 뺀다.
+ * 입력이 2^522 + 2^521보다 작으면 결과는 [0, p) 범위이다.
+ */
+static void p521_fold(p521_fe r, uint64_t v[L])
+{
+    uint64_t c[L], t[L], borrow;
+
+    memset(c, 0, sizeof(c));
+    c[0] = v[L-1] >> 9;
+    v[L-1] &= TOP_MASK;
+    add9(v, v, c);
+    borrow = sub9(t, v, P);
+    sel9(r, v, t, borrow - 1);
+}
+
+/*
+ * p521_reduce() - 1042비트 t를 mod p로 축약한다.
+ * p가 메르센 소수이므로 t = hi*2^521 + lo = hi + lo (mod p)이다. hi와 lo는 모두 2^521보다 작으므로
+ * 한 번 더하고 p521_fold()로 남은 한 비트를 접으면 된다.
+ */
+static void p521_reduce(p521_fe r, const uint64_t t[2*L])
+{
+    uint64_t lo[L], hi[L];
+    int i;
+
+    for (i = 0; i < L; i++)
+        hi[i] = (t[L-1+i] >> 9) | (t[L+i] << 55);
+    memcpy(lo, t, sizeof(lo));
+    lo[L-1] &= TOP_MASK;
+    add9(lo, lo, hi);
+    p521_fold(r, lo);
+}
+
+/*
+ * 유한체 GF(p) 연산
+ */
+
+void p521_fe_set_ui(p521_fe r, uint64_t a)
+{
+    memset(r, 0, sizeof(p521_fe));
+    r[0] = a;
+}
+
+void p521_fe_copy(p521_fe r, const p521_fe a)
+{
+    memcpy(r, a, sizeof(p521_fe));
+}
+
+void p521_fe_cmov(p521_fe r, const p521_fe a, int flag)
+{
+    sel9(r, r, a, -(uint64_t)(flag != 0));
+}
+
+// 빅 엔디안 66바이트를 읽는다. 값이 p 이상이면 mod p로 축약하고 0을 반환한다
+int p521_fe_from_bytes(p521_fe r, const unsigned char *in)
+{
+    uint64_t t[L];
+
+    load66(r, in);
+    if (sub9(t, r, P))
+        return 1;
+    // 66바이트는 2^528보다 작으므로 위쪽 7비트를 한 번 접으면 된다
+    p521_fold(r, r);
+    return 0;
+}
+
+void p521_fe_to_bytes(unsigned char *out, const p521_fe a)
+{
+    int k;
+    for (k = 0; k < P521_BYTES; k++)
+        out[P521_BYTES-1-k] = (unsigned char)(a[k/8] >> (8 * (k % 8)));
+}
+
+int p521_fe_is_zero(const p521_fe a)
+{
+    uint64_t t = 0;
+    int i;
+    for (i = 0; i < L; i++)
+        t |= a[i];
+    return t == 0;
+}
+
+int p521_fe_equal(const p521_fe a, const p521_fe b)
+{
+    uint64_t t = 0;
+    int i;
+    for (i = 0; i < L; i++)
+        t |= a[i] ^ b[i];
+    return t == 0;
+}
+
+// a + b < 2^522이므로 최상위 림에서 넘치지 않고, p 이상이면 p를 한 번 뺀다
+void p521_fe_add(p521_fe r, const p521_fe a, const p521_fe b)
+{
+    uint64_t s[L], t[L], borrow;
+
+    add9(s, a, b);
+    borrow = sub9(t, s, P);
+    sel9(r, s, t, borrow - 1);
+}
+
+void p521_fe_sub(p521_fe r, const p521_fe a, const p521_fe b)
+{
+    uint64_t d[L], t[L], borrow;
+
+    borrow = sub9(d, a, b);
+    add9(t, d, P);
+    sel9(r, d, t, -borrow);
+}
+
+void p521_fe_neg(p521_fe r, const p521_fe a)
+{
+    static const p521_fe zero = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+    p521_fe_sub(r, zero, a);
+}
+
+void p521_fe_mul(p521_fe r, const p521_fe a, const p521_fe b)
+{
+    uint64_t t[2*L];
+    mul9(t, a, b);
+    p521_reduce(r, t);
+}
+
+void p521_fe_sqr(p521_fe r, const p521_fe a)
+{
+    uint64_t t[2*L];
+    sqr9(t, a);
+    p521_reduce(r, t);
+}
+
+// r = a^(2^k)
+static void p521_fe_sqr_n(p521_fe r, const p521_fe a, int k)
+{
+    p521_fe_sqr(r, a);
+    while (--k > 0)
+        p521_fe_sqr(r, r);
+}
+
+/*
+ * p521_fe_inv() - 페르마 정리로 r = a^(p-2)를 계산한다.
+ * p - 2 = 2^521 - 3은 위에서부터 1이 519개, 01이므로 x_k = a^(2^k - 1)을 두 배씩 늘려
+ * x_512를 만들고 x_7을 붙인다. 제곱 524번과 곱셈 13번이 들어간다.
+ */
+void p521_fe_inv(p521_fe r, const p521_fe a)
+{
+    p521_fe x2, x3, x7, t;
+    int k;
+
+    p521_fe_sqr(x2, a);
+    p521_fe_mul(x2, x2, a);             // 2^2 - 1
+    p521_fe_sqr(x3, x2);
+    p521_fe_mul(x3, x3, a);             // 2^3 - 1
+    p521_fe_sqr_n(t, x2, 2);
+    p521_fe_mul(t, t, x2);              // 2^4 - 1
+    p521_fe_sqr_n(x7, t, 3);
+    p521_fe_mul(x7, x7, x3);            // 2^7 - 1
+    for (k = 4; k < 512; k *= 2) {
+        p521_fe_sqr_n(x2, t, k);
+        p521_fe_mul(t, x2, t);          // 2^(2k) - 1
+    }
+    p521_fe_sqr_n(t, t, 7);
+    p521_fe_mul(t, t, x7);              // 2^519 - 1
+    p521_fe_sqr_n(t, t, 2);
+    p521_fe_mul(r, t, a);               // ... 01
+}
+
+/*
+ * 위수 n에 대한 스칼라 연산
+ */
+
+// 몽고메리 곱셈 r = a*b*R^-1 mod n (CIOS 방식)
+static void p521_sc_montmul(uint64_t r[L], const uint64_t a[L], const uint64_t b[L])
+{
+    uint64_t t[L+2], carry, m, u[L], borrow;
+    u128 acc;
+    int i, j;
+
+    memset(t, 0, sizeof(t));
+    for (i = 0; i < L; i++) {
+        // t = t + a[i]*b
+        carry = 0;
+        for (j = 0; j < L; j++) {
+            acc = (u128)a[i] * b[j] + t[j] + carry;
+            t[j] = (uint64_t)acc;
+            carry = (uint64_t)(acc >> 64);
+        }
+        acc = (u128)t[L] + carry;
+        t[L] = (uint64_t)acc;
+        t[L+1] = (uint64_t)(acc >> 64);
+        // t = (t + m*n) / 2^64
+        m = t[0] * N0;
+        acc = (u128)m * N[0] + t[0];
+        carry = (uint64_t)(acc >> 64);
+        for (j = 1; j < L; j++) {
+            acc = (u128)m * N[j] + t[j] + carry;
+            t[j-1] = (uint64_t)acc;
+            carry = (uint64_t)(acc >> 64);
+        }
+        acc = (u128)t[L] + carry;
+        t[L-1] = (uint64_t)acc;
+        t[L] = t[L+1] + (uint64_t)(acc >> 64);
+    }
+    // t < 2n이므로 한 번만 빼면 된다
+    borrow = sub9(u, t, N);
+    sel9(r, t, u, -(t[L] | (borrow ^ 1)));
+}
+
+/*
+ * 빅 엔디안 66바이트를 읽어 mod n으로 축약한다. 원래 값이 n보다 작았으면 1을 반환한다.
+ * 66바이트는 2n보다 클 수 있으므로, n 이상이면 몽고메리 곱셈 두 번으로 (a*R^2)*R^-1*R^-1 = a mod n을 구한다.
+ */
+int p521_sc_from_bytes(p521_sc r, const unsigned char *in)
+{
+    static const uint64_t one[L] = {1, 0, 0, 0, 0, 0, 0, 0, 0};
+    uint64_t t[L];
+
+    load66(r, in);
+    if (sub9(t, r, N))
+        return 1;
+    p521_sc_montmul(t, r, RR_N);
+    p521_sc_montmul(r, t, one);
+    return 0;
+}
+
+void p521_sc_to_bytes(unsigned char *out, const p521_sc a)
+{
+    p521_fe_to_bytes(out, a);
+}
+
+int p521_sc_is_zero(const p521_sc a)
+{
+    return p521_fe_is_zero(a);
+}
+
+int p521_sc_equal(const p521_sc a, const p521_sc b)
+{
+    return p521_fe_equal(a, b);
+}
+
+void p521_sc_add(p521_sc r, const p521_sc a, const p521_sc b)
+{
+    uint64_t s[L], t[L], carry, borrow;
+
+    carry = add9(s, a, b);
+    borrow = sub9(t, s, N);
+    sel9(r, s, t, -(carry | (borrow ^ 1)));
+}
+
+void p521_sc_neg(p521_sc r, const p521_sc a)
+{
+    static const p521_sc zero = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+    uint64_t t[L];
+
+    sub9(t, N, a);
+    sel9(r, t, zero, -(uint64_t)p521_sc_is_zero(a));
+}
+
+// r = a*b mod n. 몽고메리 곱셈 결과에 R^2를 한 번 더 곱해 R^-1을 없앤다
+void p521_sc_mul(p521_sc r, const p521_sc a, const p521_sc b)
+{
+    uint64_t t[L];
+    p521_sc_montmul(t, a, b);
+    p521_sc_montmul(r, t, RR_N);
+}
+
+/*
+ * p521_sc_inv() - 페르마 정리로 r = a^(n-2) mod n을 p256_sc_inv()와 같은 4비트 고정 윈도우로 계산한다.
+ * 최상위 림의 빈 윈도우는 1을 곱하므로 연산 순서는 입력과 무관하다.
+ */
+void p521_sc_inv(p521_sc r, const p521_sc a)
+{
+    static const uint64_t E[L] = {
+        0xbb6fb71e91386407ULL, 0x3bb5c9b8899c47aeULL, 0x7fcc0148f709a5d0ULL,
+        0x51868783bf2f966bULL, 0xfffffffffffffffaULL, 0xffffffffffffffffULL,
+        0xffffffffffffffffULL, 0xffffffffffffffffULL, 0x00000000000001ffULL
+    };
+    static const uint64_t one[L] = {1, 0, 0, 0, 0, 0, 0, 0, 0};
+    uint64_t tbl[16][L], x[L];
+    int i, j, w;
+
+    // tbl[i] = a^i (몽고메리 형태), tbl[0] = R mod n
+    p521_sc_montmul(tbl[1], a, RR_N);
+    p521_sc_montmul(tbl[0], one, RR_N);
+    for (i = 2; i < 16; i++)
+        p521_sc_montmul(tbl[i], tbl[i-1], tbl[1]);
+
+    memcpy(x, tbl[0], sizeof(x));
+    for (i = 16*L - 1; i >= 0; i--) {
+        for (j = 0; j < 4; j++)
+            p521_sc_montmul(x, x, x);
+        w = (int)(E[i/16] >> (4 * (i % 16))) & 0xf;
+        p521_sc_montmul(x, x, tbl[w]);
+    }
+    p521_sc_montmul(r, x, one);
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright(c) 2020-2023 All rights reserved by Heekuck Oh.
+ * 이 프로그램은 한양대학교 ERICA 컴퓨터학부 학생을 위한 교육용으로 제작되었다.
+ * 한양대학교 ERICA 학생이 아닌 자는 이 프로그램을 수정하거나 배포할 수 없다.
+ * 프로그램을 수정할 경우 날짜, 학과, 학번, 이름, 수정 내용을 기록한다.
+ */
+#ifndef _P521_H_
+#define _P521_H_
+#include <stdint.h>
+
+#define P521_LIMBS 9
+
+/*
+ * P-521 유한체 GF(p)의 원소로, p = 2^521 - 1이다.
+ * 64비트 림 9개를 리틀 엔디안 순서로 저장하며(v[8]은 아래 9비트만 쓴다), p256_fe와 같이
+ * [0, p) 범위의 값만 주고받는다. 바이트 형식은 빅 엔디안 66바이트이다.
+ */
+typedef uint64_t p521_fe[P521_LIMBS];
+
+// 위수 n에 대한 스칼라로 [0, n) 범위의 일반 정수를 저장한다
+typedef uint64_t p521_sc[P521_LIMBS];
+
+void p521_fe_set_ui(p521_fe r, uint64_t a);
+void p521_fe_copy(p521_fe r, const p521_fe a);
+void p521_fe_cmov(p521_fe r, const p521_fe a, int flag);
+int p521_fe_from_bytes(p521_fe r, const unsigned char *in);
+void p521_fe_to_bytes(unsigned char *out, const p521_fe a);
+int p521_fe_is_zero(const p521_fe a);
+int p521_fe_equal(const p521_fe a, const p521_fe b);
+void p521_fe_add(p521_fe r, const p521_fe a, const p521_fe b);
+void p521_fe_sub(p521_fe r, const p521_fe a, const p521_fe b);
+void p521_fe_neg(p521_fe r, const p521_fe a);
+void p521_fe_mul(p521_fe r, const p521_fe a, const p521_fe b);
+void p521_fe_sqr(p521_fe r, const p521_fe a);
+void p521_fe_inv(p521_fe r, const p521_fe a);
+
+int p521_sc_from_bytes(p521_sc r, const unsigned char *in);
+void p521_sc_to_bytes(unsigned char *out, const p521_sc a);
+int p521_sc_is_zero(const p521_sc a);
+int p521_sc_equal(const p521_sc a, const p521_sc b);
+void p521_sc_add(p521_sc r, const p521_sc a, const p521_sc b);
+void p521_sc_neg(p521_sc r, const p521_sc a);
+void p521_sc_mul(p521_sc r, const p521_sc a, const p521_sc b);
+void p521_sc_inv(p521_sc r, const p521_sc a);
+
+#endif
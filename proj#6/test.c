@@ -14,7 +14,9 @@
 #endif
 #include <string.h>
 #include <time.h>
+#include <gmp.h>
 #include "ecdsa.h"
+#include "ed25519.h"
 
 char *poem = "죽는 날까지 하늘을 우러러 한 점 부끄럼이 없기를, 잎새에 이는 바람에도 나는 괴로워했다. 별을 노래하는 마음으로 모든 죽어 가는 것을 사랑해야지 그리고 나한테 주어진 길을 걸어가야겠다. 오늘 밤에도 별이 바람에 스치운다.";
 unsigned char poet_d[ECDSA_P256/8] = {0x0f,0x34,0x2f,0x4a,0xa6,0xe5,0x0d,0x19,0x0a,0x7d,0xf7,0xd9,0x07,0x56,0xa2,0x67,0x2a,0x72,0xc1,0x12,0x41,0xc3,0x41,0x85,0x63,0x07,0x52,0x84,0x1f,0x4d,0xd6,0x99};
@@ -23,15 +25,45 @@ unsigned char poem_r1[ECDSA_P256/8] = {0xcd,0x1f,0x65,0x6a,0x61,0x73,0x48,0x11,0
 unsigned char poem_s1[ECDSA_P256/8] = {0x30,0x80,0xe9,0xbb,0x67,0x8f,0x03,0x29,0x8b,0x43,0x49,0xe3,0x6f,0xb9,0xc4,0x30,0x6f,0x65,0x85,0x53,0x00,0x6e,0x7f,0x54,0x24,0x80,0x04,0xb3,0xa9,0xbe,0x81,0x60};
 unsigned char poem_r2[ECDSA_P256/8] = {0xba,0xab,0x19,0xc8,0x4f,0xaa,0x8d,0x75,0xc5,0x26,0x7e,0x71,0xca,0x12,0x7e,0x30,0x3c,0xb8,0xeb,0x36,0x41,0x29,0x70,0xc4,0x80,0x83,0xbe,0xb8,0x09,0x5f,0x7b,0x9f};
 unsigned char poem_s2[ECDSA_P256/8] = {0xdc,0x87,0xe3,0x65,0xa7,0x55,0xc0,0x98,0x6b,0xb6,0x2e,0x71,0xf6,0xda,0x72,0xb1,0xd9,0x08,0x53,0xfe,0x90,0x8f,0x9a,0xc9,0x30,0x6a,0x81,0x3f,0x78,0xa6,0x73,0x4b};
+unsigned char rfc_x[ECDSA_P256/8] = {0xc9,0xaf,0xa9,0xd8,0x45,0xba,0x75,0x16,0x6b,0x5c,0x21,0x57,0x67,0xb1,0xd6,0x93,0x4e,0x50,0xc3,0xdb,0x36,0xe8,0x9b,0x12,0x7b,0x8a,0x62,0x2b,0x12,0x0f,0x67,0x21};
+unsigned char rfc_r[ECDSA_P256/8] = {0xef,0xd4,0x8b,0x2a,0xac,0xb6,0xa8,0xfd,0x11,0x40,0xdd,0x9c,0xd4,0x5e,0x81,0xd6,0x9d,0x2c,0x87,0x7b,0x56,0xaa,0xf9,0x91,0xc3,0x4d,0x0e,0xa8,0x4e,0xaf,0x37,0x16};
+unsigned char rfc_s[ECDSA_P256/8] = {0xf7,0xcb,0x1c,0x94,0x2d,0x65,0x7c,0x41,0xd4,0x36,0xc7,0xa1,0xb6,0xe2,0x9f,0x65,0xf3,0xe9,0x00,0xdb,0xb9,0xaf,0xf4,0x06,0x4d,0xc4,0xab,0x2f,0x84,0x3a,0xcd,0xa8};
+unsigned char rfc384_x[ECDSA_P384/8] = {0x6b,0x9d,0x3d,0xad,0x2e,0x1b,0x8c,0x1c,0x05,0xb1,0x98,0x75,0xb6,0x65,0x9f,0x4d,0xe2,0x3c,0x3b,0x66,0x7b,0xf2,0x97,0xba,0x9a,0xa4,0x77,0x40,0x78,0x71,0x37,0xd8,0x96,0xd5,0x72,0x4e,0x4c,0x70,0xa8,0x25,0xf8,0x72,0xc9,0xea,0x60,0xd2,0xed,0xf5};
+unsigned char rfc384_r[ECDSA_P384/8] = {0x94,0xed,0xbb,0x92,0xa5,0xec,0xb8,0xaa,0xd4,0x73,0x6e,0x56,0xc6,0x91,0x91,0x6b,0x3f,0x88,0x14,0x06,0x66,0xce,0x9f,0xa7,0x3d,0x64,0xc4,0xea,0x95,0xad,0x13,0x3c,0x81,0xa6,0x48,0x15,0x2e,0x44,0xac,0xf9,0x6e,0x36,0xdd,0x1e,0x80,0xfa,0xbe,0x46};
+unsigned char rfc384_s[ECDSA_P384/8] = {0x99,0xef,0x4a,0xeb,0x15,0xf1,0x78,0xce,0xa1,0xfe,0x40,0xdb,0x26,0x03,0x13,0x8f,0x13,0x0e,0x74,0x0a,0x19,0x62,0x45,0x26,0x20,0x3b,0x63,0x51,0xd0,0xa3,0xa9,0x4f,0xa3,0x29,0xc1,0x45,0x78,0x6e,0x67,0x9e,0x7b,0x82,0xc7,0x1a,0x38,0x62,0x8a,0xc8};
+unsigned char k256_r[ECDSA_P256/8] = {0x93,0x4b,0x1e,0xa1,0x0a,0x4b,0x3c,0x17,0x57,0xe2,0xb0,0xc0,0x17,0xd0,0xb6,0x14,0x3c,0xe3,0xc9,0xa7,0xe6,0xa4,0xa4,0x98,0x60,0xd7,0xa6,0xab,0x21,0x0e,0xe3,0xd8};
+unsigned char ed_seed[32] = {0x9d,0x61,0xb1,0x9d,0xef,0xfd,0x5a,0x60,0xba,0x84,0x4a,0xf4,0x92,0xec,0x2c,0xc4,0x44,0x49,0xc5,0x69,0x7b,0x32,0x69,0x19,0x70,0x3b,0xac,0x03,0x1c,0xae,0x7f,0x60};
+unsigned char ed_pk[ED25519_PUBLIC_BYTES] = {0xd7,0x5a,0x98,0x01,0x82,0xb1,0x0a,0xb7,0xd5,0x4b,0xfe,0xd3,0xc9,0x64,0x07,0x3a,0x0e,0xe1,0x72,0xf3,0xda,0xa6,0x23,0x25,0xaf,0x02,0x1a,0x68,0xf7,0x07,0x51,0x1a};
+unsigned char ed_sig[ED25519_SIG_BYTES] = {0xe5,0x56,0x43,0x00,0xc3,0x60,0xac,0x72,0x90,0x86,0xe2,0xcc,0x80,0x6e,0x82,0x8a,0x84,0x87,0x7f,0x1e,0xb8,0xe5,0xd9,0x74,0xd8,0x73,0xe0,0x65,0x22,0x49,0x01,0x55,0x5f,0xb8,0x82,0x15,0x90,0xa3,0x3b,0xac,0xc6,0x1e,0x39,0x70,0x1c,0xf9,0xb4,0x6b,0xd2,0x5b,0xf5,0xf0,0x59,0x5b,0xbe,0x24,0x65,0x51,0x41,0x43,0x8e,0x7a,0x10,0x0b};
 
 int main(void)
 {
     long data;
+    unsigned long hits, misses, misses1;
+    ecdsa_ctx_t *ctx1, *ctx2;
+    ecdsa_pool_t *pool;
+    ecdsa_p256_t Q1, Q2;
+    mpz_t mp, mn, my, ml, mx, md;
+    unsigned char comp[ECDSA_P256_COMPRESSED];
+    unsigned char d1[ECDSA_P256/8], z[ECDSA_P256/8], z1[ECDSA_P256/8];
+    unsigned char batch_d[ECDSA_P256/8], batch_rbuf[16][ECDSA_P256/8], batch_sbuf[16][ECDSA_P256/8];
+    ecdsa_p256_t batch_Q[16];
+    long batch_data[16];
+    size_t batch_len[16];
+    const void *batch_msg[16], *batch_r[16], *batch_s[16];
+    void *batch_rp[16], *batch_sp[16];
+    int batch_res[16], batch_recid[16];
+    ecdsa_stats_t stats;
     int i, count,val;
     unsigned char d[ECDSA_P256/8];
     ecdsa_p256_t Q;
     unsigned char r[ECDSA_P256/8], s[ECDSA_P256/8];
     unsigned char r1[ECDSA_P256/8], s1[ECDSA_P256/8];
+    unsigned char gd[ECDSA_BYTES(ECDSA_P521)], gr[ECDSA_BYTES(ECDSA_P521)], gs[ECDSA_BYTES(ECDSA_P521)];
+    ecdsa_p521_t gQ;
+    unsigned char ed_sks[16][ED25519_SECRET_BYTES], ed_pks[16][ED25519_PUBLIC_BYTES], ed_sigs[16][ED25519_SIG_BYTES];
+    const void *ed_pkp[16], *ed_sigp[16];
+    const ecdsa_curve_t *curves[3] = {&ecdsa_curve_p384, &ecdsa_curve_p521, &ecdsa_curve_secp256k1};
     clock_t start, end;
     double cpu_time;
 
@@ -39,7 +71,10 @@ int main(void)
     /*
      * ECDSA 키 생성 시험
      */
-    ecdsa_p256_init();
+    if (ecdsa_p256_init() != 0) {
+        printf("ECDSA initialization ...FAILED\n");
+        return 1;
+    }
     ecdsa_p256_key(d, &Q);
     printf("d = ");
     for (i = 0; i < ECDSA_P256/8; ++i)
@@ -73,8 +108,8 @@ int main(void)
         printf(" ...FAILED: signature generation error = %d\n", val);
         return 1;
     };
-    if (memcmp(r, r1, ECDSA_P256/8) == 0 || memcmp(s, s1, ECDSA_P256/8) == 0) {
-        printf(" ...FAILED: k may not be random\n");
+    if (memcmp(r, r1, ECDSA_P256/8) != 0 || memcmp(s, s1, ECDSA_P256/8) != 0) {
+        printf(" ...FAILED: k is not deterministic\n");
         return 1;
     };        
     if ((val = ecdsa_p256_verify(poem, strlen(poem), &Q, r, s, SHA512_224)) != 0) {
@@ -148,10 +183,347 @@ int main(void)
         printf("Valid signature ...PASSED\n");
     printf("---\n");
     
+    /*
+     * 같은 공개키로 반복해서 검증하면 캐시에 저장된 표를 사용하는지 시험한다.
+     */
+    for (i = 0; i < 8; ++i)
+        if ((val = ecdsa_p256_verify(poem, strlen(poem), &poet_Q, poem_r1, poem_s1, SHA224)) != 0) {
+            printf("Signature verification error = %d ...FAILED\n", val);
+            return 1;
+        }
+    if (ecdsa_p256_verify(poem, strlen(poem)+1, &poet_Q, poem_r1, poem_s1, SHA224) == 0) {
+        printf("Signature varification error ...FAILED\n");
+        return 1;
+    }
+    ecdsa_p256_cache_stats(&hits, &misses);
+    if (hits == 0) {
+        printf("Public key cache was not used ...FAILED\n");
+        return 1;
+    }
+    else
+        printf("Public key cache hits = %lu, misses = %lu ...PASSED\n", hits, misses);
+    /*
+     * 곡선 위에 없는 공개키는 캐시를 찾기 전에 거부되어야 한다.
+     */
+    Q1 = poet_Q;
+    Q1.y[ECDSA_P256/8-1] ^= 1;
+    for (i = 0; i < 8; ++i)
+        if ((val = ecdsa_p256_verify(poem, strlen(poem), &Q1, poem_r1, poem_s1, SHA224)) != ECDSA_POINT_INVALID) {
+            printf("Signature verification with invalid Q = %d ...FAILED\n", val);
+            return 1;
+        }
+    ecdsa_p256_cache_stats(&hits, &misses1);
+    if (misses1 != misses) {
+        printf("Invalid Q reached the public key cache ...FAILED\n");
+        return 1;
+    }
+    printf("Signature verification with invalid Q = %d ...PASSED\n", val);
+    printf("---\n");
+    
+    /*
+     * RFC 6979 A.2.5의 P-256, SHA-256, "sample" 시험 벡터로 결정적 서명을 확인한다.
+     */
+    if ((val = ecdsa_p256_sign("sample", 6, rfc_x, r, s, SHA256)) != 0) {
+        printf(" ...FAILED: signature generation error = %d\n", val);
+        return 1;
+    };
+    if (memcmp(r, rfc_r, ECDSA_P256/8) != 0 || memcmp(s, rfc_s, ECDSA_P256/8) != 0) {
+        printf("RFC 6979 signature ...FAILED\n");
+        return 1;
+    }
+    else
+        printf("RFC 6979 signature ...PASSED\n");
+    printf("---\n");
+    
+    /*
+     * 공개키를 압축했다가 풀어 원래 키가 나오는지, 곡선 위에 없는 점을 거부하는지 시험한다.
+     */
+    for (i = 0; i < 64; ++i) {
+        ecdsa_p256_key(d, &Q);
+        if (ecdsa_p256_compress(comp, &Q) || ecdsa_p256_decompress(&Q1, comp) || memcmp(&Q, &Q1, sizeof(Q)) != 0) {
+            printf("Point compression ...FAILED\n");
+            return 1;
+        }
+    }
+    Q.y[0] ^= 1;
+    if (ecdsa_p256_compress(comp, &Q) != ECDSA_POINT_INVALID) {
+        printf("Compressing a point not on the curve ...FAILED\n");
+        return 1;
+    }
+    memset(comp, 0, ECDSA_P256_COMPRESSED);
+    comp[0] = 0x02;
+    comp[ECDSA_P256_COMPRESSED-1] = 0x01;   // x = 1은 곡선 위의 점의 x좌표가 아니다
+    if (ecdsa_p256_decompress(&Q1, comp) != ECDSA_POINT_INVALID) {
+        printf("Decompressing a point not on the curve ...FAILED\n");
+        return 1;
+    }
+    printf("Point compression ...PASSED\n");
+    printf("---\n");
+    
+    /*
+     * 두 사용자가 ECDH로 같은 공유 비밀을 얻는지, 곡선 위에 없는 공개키를 거부하는지 시험한다.
+     */
+    for (i = 0; i < 64; ++i) {
+        ecdsa_p256_key(d, &Q);
+        ecdsa_p256_key(d1, &Q1);
+        if (ecdh_p256(d, &Q1, z) || ecdh_p256(d1, &Q, z1) || memcmp(z, z1, ECDSA_P256/8) != 0) {
+            printf("ECDH key agreement ...FAILED\n");
+            return 1;
+        }
+    }
+    Q.x[ECDSA_P256/8-1] ^= 1;
+    if (ecdh_p256(d1, &Q, z) != ECDSA_POINT_INVALID) {
+        printf("ECDH with a point not on the curve ...FAILED\n");
+        return 1;
+    }
+    /*
+     * x = 0인 점 Q0 = (0, √b)는 사다리가 Z를 복원할 수 없는 공개키이다. 2Q0 = (9/4b, -λx - √b),
+     * λ = -3/(2√b)를 따로 계산해 x((2d)Q0) = x(d(2Q0))인지 확인한다. 오른쪽은 사다리로 계산된다.
+     */
+    memset(comp, 0, sizeof(comp));
+    comp[0] = 0x02;
+    if (ecdsa_p256_decompress(&Q, comp)) {
+        printf("ECDH with x = 0 ...FAILED: no point\n");
+        return 1;
+    }
+    mpz_inits(mp, mn, my, ml, mx, md, NULL);
+    mpz_set_str(mp, "FFFFFFFF00000001000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFF", 16);
+    mpz_set_str(mn, "FFFFFFFF00000000FFFFFFFFFFFFFFFFBCE6FAADA7179E84F3B9CAC2FC632551", 16);
+    mpz_import(my, ECDSA_P256/8, 1, 1, 1, 0, Q.y);
+    mpz_mul_2exp(ml, my, 1);
+    mpz_invert(ml, ml, mp);
+    mpz_mul_si(ml, ml, -3);
+    mpz_mod(ml, ml, mp);                    // λ = -3/(2y)
+    mpz_mul(mx, ml, ml);
+    mpz_mod(mx, mx, mp);                    // x2 = λ^2
+    mpz_mul(ml, ml, mx);
+    mpz_add(ml, ml, my);
+    mpz_neg(ml, ml);
+    mpz_mod(my, ml, mp);                    // y2 = -λx2 - y
+    memset(&Q1, 0, sizeof(Q1));
+    mpz_export(Q1.x + ECDSA_P256/8 - (mpz_sizeinbase(mx, 2) + 7)/8, NULL, 1, 1, 1, 0, mx);
+    mpz_export(Q1.y + ECDSA_P256/8 - (mpz_sizeinbase(my, 2) + 7)/8, NULL, 1, 1, 1, 0, my);
+    for (i = 0; i < 64; ++i) {
+        ecdsa_p256_key(d, &Q2);
+        mpz_import(md, ECDSA_P256/8, 1, 1, 1, 0, d);
+        mpz_mul_2exp(md, md, 1);
+        mpz_mod(md, md, mn);
+        memset(d1, 0, sizeof(d1));
+        mpz_export(d1 + ECDSA_P256/8 - (mpz_sizeinbase(md, 2) + 7)/8, NULL, 1, 1, 1, 0, md);
+        if (ecdh_p256(d1, &Q, z) || ecdh_p256(d, &Q1, z1) || memcmp(z, z1, ECDSA_P256/8) != 0) {
+            printf("ECDH with x = 0 ...FAILED\n");
+            return 1;
+        }
+    }
+    mpz_clears(mp, mn, my, ml, mx, md, NULL);
+    printf("ECDH key agreement ...PASSED\n");
+    printf("---\n");
+    
+    /*
+     * 서명과 복원 색인으로 공개키를 복원하는지 시험한다. 다른 서명기가 만든 poem 서명은 y의 홀짝을
+     * 모르므로 두 복원 색인 중 하나가 poet_Q를 내야 한다.
+     */
+    for (i = 0; i < 64; ++i) {
+        ecdsa_p256_key(d, &Q);
+        arc4random_buf(&data, sizeof(long));
+        if (ecdsa_p256_sign_recid(&data, sizeof(long), d, r, s, &val, SHA256) ||
+            ecdsa_p256_recover(&data, sizeof(long), r, s, val, &Q1, SHA256) || memcmp(&Q, &Q1, sizeof(Q)) != 0) {
+            printf("Public key recovery ...FAILED\n");
+            return 1;
+        }
+    }
+    if ((ecdsa_p256_recover(poem, strlen(poem), poem_r1, poem_s1, 0, &Q1, SHA224) || memcmp(&poet_Q, &Q1, sizeof(Q)) != 0) &&
+        (ecdsa_p256_recover(poem, strlen(poem), poem_r1, poem_s1, 1, &Q1, SHA224) || memcmp(&poet_Q, &Q1, sizeof(Q)) != 0)) {
+        printf("Public key recovery of poem signature ...FAILED\n");
+        return 1;
+    }
+    printf("Public key recovery ...PASSED\n");
+    printf("---\n");
+    
+    /*
+     * 곡선 기술자로 P-384와 P-521에서 서명하고 검증한다. 일반 경로의 P-256 서명은 전용 경로와 같아야 하고,
+     * P-384의 (r, s)는 RFC 6979 A.2.6의 값과 같아야 한다.
+     * secp256k1은 d = 1로 "Satoshi Nakamoto"를 서명한 널리 쓰이는 RFC 6979 시험 값과 r을 비교한다.
+     */
+    if (ecdsa_sign(&ecdsa_curve_p256, "sample", 6, rfc_x, gr, gs, SHA256) ||
+        memcmp(gr, rfc_r, ECDSA_P256/8) != 0 || memcmp(gs, rfc_s, ECDSA_P256/8) != 0) {
+        printf("Generic P-256 signature ...FAILED\n");
+        return 1;
+    }
+    if (ecdsa_sign(&ecdsa_curve_p384, "sample", 6, rfc384_x, gr, gs, SHA384) ||
+        memcmp(gr, rfc384_r, ECDSA_P384/8) != 0 || memcmp(gs, rfc384_s, ECDSA_P384/8) != 0) {
+        printf("P-384 RFC 6979 signature ...FAILED\n");
+        return 1;
+    }
+    memset(gd, 0, ECDSA_P256/8);
+    gd[ECDSA_P256/8 - 1] = 1;
+    if (ecdsa_sign(&ecdsa_curve_secp256k1, "Satoshi Nakamoto", 16, gd, gr, gs, SHA256) || memcmp(gr, k256_r, ECDSA_P256/8) != 0) {
+        printf("secp256k1 RFC 6979 signature ...FAILED\n");
+        return 1;
+    }
+    for (i = 0; i < 18; ++i) {
+        const ecdsa_curve_t *C = curves[i % 3];
+        
+        ecdsa_key(C, gd, &gQ);
+        if (ecdsa_sign(C, poem, strlen(poem), gd, gr, gs, i % 6) ||
+            ecdsa_verify(C, poem, strlen(poem), &gQ, gr, gs, i % 6) ||
+            ecdsa_verify(C, poem, strlen(poem)-1, &gQ, gr, gs, i % 6) != ECDSA_SIG_MISMATCH) {
+            printf("Signature on curve %d ...FAILED\n", i % 3);
+            return 1;
+        }
+    }
+    printf("P-384, P-521 and secp256k1 signatures ...PASSED\n");
+    printf("---\n");
+    
+    /*
+     * 따로 만든 문맥으로 서명하고 다른 문맥과 기본 문맥으로 검증한다.
+     */
+    if ((ctx1 = ecdsa_ctx_new()) == NULL || (ctx2 = ecdsa_ctx_new()) == NULL) {
+        printf("Context creation ...FAILED\n");
+        return 1;
+    }
+    ecdsa_ctx_key(ctx1, d, &Q);
+    if (ecdsa_ctx_sign(ctx1, poem, strlen(poem), d, r, s, SHA256) ||
+        ecdsa_ctx_verify(ctx2, poem, strlen(poem), &Q, r, s, SHA256) ||
+        ecdsa_p256_verify(poem, strlen(poem), &Q, r, s, SHA256)) {
+        printf("Signature with separate contexts ...FAILED\n");
+        return 1;
+    }
+    else
+        printf("Valid signature with separate contexts ...PASSED\n");
+    ecdsa_ctx_free(ctx1);
+    ecdsa_ctx_free(ctx2);
+    printf("---\n");
+    
+    /*
+     * 서명 풀로 서명하고 검증한다. 풀의 k는 무작위이므로 같은 메시지라도 서명이 달라야 한다.
+     */
+    if ((pool = ecdsa_pool_new(64)) == NULL) {
+        printf("Signing pool creation ...FAILED\n");
+        return 1;
+    }
+    ecdsa_p256_key(d, &Q);
+    for (i = 0; i < 256; ++i) {
+        if (ecdsa_pool_sign(pool, poem, strlen(poem), d, r, s, SHA256) ||
+            ecdsa_p256_verify(poem, strlen(poem), &Q, r, s, SHA256)) {
+            printf("Signature with signing pool ...FAILED\n");
+            return 1;
+        }
+        if (i > 0 && memcmp(r, r1, ECDSA_P256/8) == 0) {
+            printf(" ...FAILED: pool k may not be random\n");
+            return 1;
+        }
+        memcpy(r1, r, ECDSA_P256/8);
+    }
+    ecdsa_pool_free(pool);
+    printf("Valid signatures with signing pool ...PASSED\n");
+    printf("---\n");
+    
+    /*
+     * 여러 서명을 한꺼번에 검증한다. 시인의 서명과 함께 묶고, 하나는 메시지를 바꿔 실패하는지 확인한다.
+     * 시인의 서명은 복원 색인을 모르므로 -1을 넣고, 복원 색인을 하나도 주지 않아도 결과가 같은지 본다.
+     */
+    for (i = 0; i < 16; ++i) {
+        ecdsa_p256_key(batch_d, &batch_Q[i]);
+        batch_data[i] = i;
+        batch_len[i] = sizeof(long);
+        batch_msg[i] = &batch_data[i];
+        batch_r[i] = batch_rbuf[i];
+        batch_s[i] = batch_sbuf[i];
+        if (ecdsa_p256_sign_recid(&batch_data[i], sizeof(long), batch_d, batch_rbuf[i], batch_sbuf[i], &batch_recid[i], SHA224)) {
+            printf(" ...FAILED signature generation\n");
+            return 1;
+        }
+    }
+    batch_msg[5] = poem;
+    batch_len[5] = strlen(poem);
+    batch_Q[5] = poet_Q;
+    batch_r[5] = poem_r1;
+    batch_s[5] = poem_s1;
+    batch_recid[5] = -1;
+    batch_data[11]++;
+    for (count = 0; count < 2; ++count) {
+        if (ecdsa_p256_verify_batch(batch_msg, batch_len, batch_Q, batch_r, batch_s, count ? NULL : batch_recid, 16, batch_res, SHA224) != ECDSA_SIG_MISMATCH) {
+            printf("Batch verification ...FAILED\n");
+            return 1;
+        }
+        for (i = 0; i < 16; ++i)
+            if ((i == 11) != (batch_res[i] != 0)) {
+                printf("Batch verification result[%d] = %d ...FAILED\n", i, batch_res[i]);
+                return 1;
+            }
+    }
+    printf("Batch verification error = %d at 11 only ...PASSED\n", batch_res[11]);
+    printf("---\n");
+    
+    /*
+     * 같은 키로 여러 메시지를 한꺼번에 서명하고 하나씩 서명한 결과와 같은지 확인한다.
+     * 네 쌍을 한꺼번에 만든 키로 서명한 것이 검증되는지도 본다.
+     */
+    for (i = 0; i < 16; ++i) {
+        batch_rp[i] = batch_rbuf[i];
+        batch_sp[i] = batch_sbuf[i];
+    }
+    ecdsa_p256_key(batch_d, &Q);
+    if (ecdsa_p256_sign_batch(batch_msg, batch_len, batch_d, batch_rp, batch_sp, 16, SHA256)) {
+        printf("Batch signature generation ...FAILED\n");
+        return 1;
+    }
+    for (i = 0; i < 16; ++i) {
+        ecdsa_p256_sign(batch_msg[i], batch_len[i], batch_d, r, s, SHA256);
+        if (memcmp(r, batch_rbuf[i], ECDSA_P256/8) != 0 || memcmp(s, batch_sbuf[i], ECDSA_P256/8) != 0) {
+            printf("Batch signature %d ...FAILED\n", i);
+            return 1;
+        }
+    }
+    printf("Batch signatures match single signatures ...PASSED\n");
+    for (i = 0; i < 4; ++i)
+        batch_rp[i] = batch_rbuf[i];
+    ecdsa_p256_key_x4(batch_rp, batch_Q);
+    for (i = 0; i < 4; ++i) {
+        ecdsa_p256_sign(batch_msg[i], batch_len[i], batch_rbuf[i], r, s, SHA256);
+        if ((val = ecdsa_p256_verify(batch_msg[i], batch_len[i], &batch_Q[i], r, s, SHA256)) != 0) {
+            printf("4-way key %d: signature verification error = %d ...FAILED\n", i, val);
+            return 1;
+        }
+    }
+    printf("4-way key generation ...PASSED\n");
+    printf("---\n");
+    
+    /*
+     * Ed25519로 RFC 8032 7.1의 TEST 1을 확인한 뒤 16개를 묶어 검증하고, 잘못된 서명 하나만 찾아내는지 본다.
+     */
+    ed25519_seed_key(ed_seed, ed_sks[0], ed_pks[0]);
+    ed25519_sign("", 0, ed_sks[0], ed_sigs[0]);
+    if (memcmp(ed_pks[0], ed_pk, ED25519_PUBLIC_BYTES) != 0 || memcmp(ed_sigs[0], ed_sig, ED25519_SIG_BYTES) != 0 ||
+        ed25519_verify("", 0, ed_pk, ed_sig) || ed25519_verify("", 1, ed_pk, ed_sig) != ED25519_SIG_MISMATCH) {
+        printf("Ed25519 RFC 8032 test vector ...FAILED\n");
+        return 1;
+    }
+    for (i = 0; i < 16; ++i) {
+        ed25519_key(ed_sks[i], ed_pks[i]);
+        ed25519_sign(batch_msg[i], batch_len[i], ed_sks[i], ed_sigs[i]);
+        ed_pkp[i] = ed_pks[i];
+        ed_sigp[i] = ed_sigs[i];
+    }
+    ed_sigs[7][40] ^= 1;
+    if (ed25519_verify_batch(batch_msg, batch_len, ed_pkp, ed_sigp, 16, batch_res) != ED25519_SIG_MISMATCH) {
+        printf("Ed25519 batch verification ...FAILED\n");
+        return 1;
+    }
+    for (i = 0; i < 16; ++i)
+        if ((i == 7) != (batch_res[i] != 0)) {
+            printf("Ed25519 batch verification result[%d] = %d ...FAILED\n", i, batch_res[i]);
+            return 1;
+        }
+    printf("Ed25519 signatures and batch verification ...PASSED\n");
+    printf("---\n");
+    
     /*
      * 키 생성, 서명, 검증을 해시함수를 변경해 가면서 반복적으로 수행한다.
      */
     printf("Random Testing"); fflush(stdout);
+    ecdsa_stats_reset();
     count = 0;
     do {
         ecdsa_p256_key(d, &Q);
@@ -176,6 +548,14 @@ int main(void)
     } while (count < 0x4fff);
     printf(" ...PASSED\n");
     ecdsa_p256_clear();
+    if (ecdsa_stats_get(&stats)) {
+        static const char *phase[ECDSA_STAT_PHASES] = {"hash", "mul", "inv", "cmp", "misc"};
+        printf("단계별 평균 사이클 (서명 %llu회, 검증 %llu회)\n", stats.sign_calls, stats.verify_calls);
+        for (i = 0; i < ECDSA_STAT_PHASES; i++)
+            printf("  %-4s  sign %10.0f  verify %10.0f\n", phase[i],
+                   (double)stats.sign[i] / (stats.sign_calls ? stats.sign_calls : 1),
+                   (double)stats.verify[i] / (stats.verify_calls ? stats.verify_calls : 1));
+    }
     
     end = clock();
     cpu_time = ((double)(end - start)) / CLOCKS_PER_SEC;